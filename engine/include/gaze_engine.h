@@ -0,0 +1,71 @@
+#ifndef GAZE_ENGINE_H
+#define GAZE_ENGINE_H
+
+/*
+ * gaze_engine - native inference core for the eye tracker.
+ *
+ * Takes the per-frame FaceMesh landmark buffer (478 normalized x/y pairs)
+ * and produces the looking/not-looking decision plus eye and iris centers
+ * in a single call, so the Python side does one FFI call per frame instead
+ * of eight landmark-math calls.
+ *
+ * Plain C ABI so the Python binding can use ctypes.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of landmarks FaceMesh produces with refine_landmarks=True. */
+#define GE_NUM_LANDMARKS 478
+
+typedef struct {
+    float left_eye_x, left_eye_y;    /* eye centers, pixel coords */
+    float right_eye_x, right_eye_y;
+    float left_iris_x, left_iris_y;  /* iris centers, pixel coords */
+    float right_iris_x, right_iris_y;
+    float left_dx, left_dy;          /* iris offset from eye center */
+    float right_dx, right_dy;
+    int looking;                     /* 1 = looking at screen */
+    float left_ear, right_ear;       /* eye aspect ratios (blink gate) */
+} ge_gaze_result;
+
+typedef struct ge_engine ge_engine;
+
+/* Create/destroy an engine instance. One instance per tracked stream. */
+ge_engine *ge_create(void);
+void ge_destroy(ge_engine *engine);
+
+/*
+ * Exponential smoothing factor for the dx/dy offsets feeding the
+ * decision, applied incrementally in O(1) per frame. alpha in (0, 1];
+ * 1.0 disables smoothing. Default is 0.4.
+ */
+void ge_set_smoothing(ge_engine *engine, float alpha);
+
+/* Clear temporal state (smoothed offsets). Call on tracking loss. */
+void ge_reset(ge_engine *engine);
+
+/*
+ * Override the "iris centered" pixel thresholds, e.g. from a per-user
+ * calibration profile. Defaults are 4 (horizontal) and 2 (vertical).
+ */
+void ge_set_thresholds(ge_engine *engine, float horizontal, float vertical);
+
+/*
+ * Compute all gaze features and the screen-attention decision from one
+ * frame's landmarks. `landmarks_xy` is GE_NUM_LANDMARKS interleaved
+ * normalized (x, y) pairs as produced by FaceMesh. Returns 0 on success,
+ * -1 on bad arguments.
+ */
+int ge_process_landmarks(ge_engine *engine,
+                         const float *landmarks_xy,
+                         int num_landmarks,
+                         int img_w, int img_h,
+                         ge_gaze_result *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GAZE_ENGINE_H */
@@ -0,0 +1,219 @@
+#include "gaze_engine.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+
+// Landmark index sets for MediaPipe Face Mesh. These mirror the sets the
+// Python tracker used (LEFT_EYE / RIGHT_EYE / LEFT_IRIS / RIGHT_IRIS) but
+// as compile-time constants so the gathers unroll.
+constexpr std::array<int, 6> kLeftEye{362, 385, 387, 263, 373, 380};
+constexpr std::array<int, 6> kRightEye{33, 160, 158, 133, 153, 144};
+constexpr std::array<int, 4> kLeftIris{474, 475, 476, 477};
+constexpr std::array<int, 4> kRightIris{469, 470, 471, 472};
+
+// Eye aspect ratio below this means the eye is mid-blink and its iris
+// offsets are garbage; such an eye is excluded from the decision.
+constexpr float kEarBlinkThreshold = 0.2f;
+
+// Default "looking at screen" thresholds, pixels of iris offset from eye
+// center. Overridable per engine via ge_set_thresholds (calibration).
+constexpr float kHorizontalThreshold = 4.0f;
+constexpr float kVerticalThreshold = 2.0f;
+
+struct Point {
+    float x;
+    float y;
+};
+
+// Mean of the selected landmarks, scaled from normalized to pixel coords.
+template <std::size_t N>
+Point center_of(const float *landmarks_xy, const std::array<int, N> &indices,
+                float img_w, float img_h) {
+    float sx = 0.0f;
+    float sy = 0.0f;
+    for (int idx : indices) {
+        sx += landmarks_xy[2 * idx];
+        sy += landmarks_xy[2 * idx + 1];
+    }
+    const float inv_n = 1.0f / static_cast<float>(N);
+    return {sx * inv_n * img_w, sy * inv_n * img_h};
+}
+
+// Eye aspect ratio over the 6-point eye contour: (two vertical gaps) /
+// (2 * horizontal span). Index order in the eye sets is corner, upper,
+// upper, corner, lower, lower - the classic EAR ordering.
+template <std::size_t N>
+float aspect_ratio(const float *landmarks_xy, const std::array<int, N> &idx,
+                   float img_w, float img_h) {
+    static_assert(N == 6, "EAR needs the 6-point eye contour");
+    auto px = [&](int i) { return landmarks_xy[2 * idx[i]] * img_w; };
+    auto py = [&](int i) { return landmarks_xy[2 * idx[i] + 1] * img_h; };
+    const float v1 = std::hypot(px(1) - px(5), py(1) - py(5));
+    const float v2 = std::hypot(px(2) - px(4), py(2) - py(4));
+    const float span = std::hypot(px(0) - px(3), py(0) - py(3));
+    return span > 0.0f ? (v1 + v2) / (2.0f * span) : 0.0f;
+}
+
+// All per-frame geometry: centers, raw offsets, and the two eye aspect
+// ratios. Kept apart from the decision state machine so the fixed-
+// resolution instantiations below share one body.
+inline void compute_geometry(const float *landmarks_xy, float w, float h,
+                             ge_gaze_result *out, float raw[4]) {
+    const Point left_eye = center_of(landmarks_xy, kLeftEye, w, h);
+    const Point right_eye = center_of(landmarks_xy, kRightEye, w, h);
+    const Point left_iris = center_of(landmarks_xy, kLeftIris, w, h);
+    const Point right_iris = center_of(landmarks_xy, kRightIris, w, h);
+
+    out->left_eye_x = left_eye.x;
+    out->left_eye_y = left_eye.y;
+    out->right_eye_x = right_eye.x;
+    out->right_eye_y = right_eye.y;
+    out->left_iris_x = left_iris.x;
+    out->left_iris_y = left_iris.y;
+    out->right_iris_x = right_iris.x;
+    out->right_iris_y = right_iris.y;
+
+    raw[0] = left_iris.x - left_eye.x;
+    raw[1] = left_iris.y - left_eye.y;
+    raw[2] = right_iris.x - right_eye.x;
+    raw[3] = right_iris.y - right_eye.y;
+
+    out->left_ear = aspect_ratio(landmarks_xy, kLeftEye, w, h);
+    out->right_ear = aspect_ratio(landmarks_xy, kRightEye, w, h);
+}
+
+// Deployments run one fixed camera mode per site, so the common modes
+// get compile-time instantiations: with W/H known the normalized->pixel
+// scale factors fold into constants and the index gathers (already
+// constexpr arrays) unroll into a branch-free straight-line kernel.
+template <int W, int H>
+void compute_geometry_fixed(const float *landmarks_xy, ge_gaze_result *out,
+                            float raw[4]) {
+    compute_geometry(landmarks_xy, static_cast<float>(W),
+                     static_cast<float>(H), out, raw);
+}
+
+}  // namespace
+
+struct ge_engine {
+    // Decision thresholds (overridable from a calibration profile)
+    float horizontal_threshold = kHorizontalThreshold;
+    float vertical_threshold = kVerticalThreshold;
+
+    bool iris_centered(float dx, float dy) const {
+        return std::fabs(dx) < horizontal_threshold &&
+               std::fabs(dy) < vertical_threshold;
+    }
+
+    // Exponentially smoothed dx/dy offsets (left then right). Smoothing
+    // the offsets instead of the raw decision keeps single-frame landmark
+    // jitter from flipping the state and resetting the look-away timer.
+    float smoothing_alpha = 0.4f;
+    bool has_ema = false;
+    float ema[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    // Last decision, held through full blinks so a slow blink can't
+    // start the look-away timer. Starts as "looking" (benign default).
+    int prev_looking = 1;
+};
+
+extern "C" {
+
+ge_engine *ge_create(void) {
+    return new ge_engine();
+}
+
+void ge_destroy(ge_engine *engine) {
+    delete engine;
+}
+
+void ge_set_smoothing(ge_engine *engine, float alpha) {
+    if (engine != nullptr && alpha > 0.0f && alpha <= 1.0f) {
+        engine->smoothing_alpha = alpha;
+    }
+}
+
+void ge_reset(ge_engine *engine) {
+    if (engine != nullptr) {
+        engine->has_ema = false;
+        engine->prev_looking = 1;
+    }
+}
+
+void ge_set_thresholds(ge_engine *engine, float horizontal, float vertical) {
+    if (engine != nullptr && horizontal > 0.0f && vertical > 0.0f) {
+        engine->horizontal_threshold = horizontal;
+        engine->vertical_threshold = vertical;
+    }
+}
+
+int ge_process_landmarks(ge_engine *engine,
+                         const float *landmarks_xy,
+                         int num_landmarks,
+                         int img_w, int img_h,
+                         ge_gaze_result *out) {
+    if (engine == nullptr || landmarks_xy == nullptr || out == nullptr ||
+        num_landmarks < GE_NUM_LANDMARKS || img_w <= 0 || img_h <= 0) {
+        return -1;
+    }
+
+    // Specialized kernels for the deployed camera modes; anything else
+    // takes the generic runtime-scale path
+    float raw[4];
+    if (img_w == 640 && img_h == 480) {
+        compute_geometry_fixed<640, 480>(landmarks_xy, out, raw);
+    } else if (img_w == 1280 && img_h == 720) {
+        compute_geometry_fixed<1280, 720>(landmarks_xy, out, raw);
+    } else if (img_w == 1920 && img_h == 1080) {
+        compute_geometry_fixed<1920, 1080>(landmarks_xy, out, raw);
+    } else {
+        compute_geometry(landmarks_xy, static_cast<float>(img_w),
+                         static_cast<float>(img_h), out, raw);
+    }
+
+    // Blink gate: a collapsed eye reads garbage offsets, so it gets
+    // zero weight in the decision and leaves its EMA untouched
+    const bool left_open = out->left_ear >= kEarBlinkThreshold;
+    const bool right_open = out->right_ear >= kEarBlinkThreshold;
+
+    if (left_open || right_open) {
+        // Incremental EMA over the offsets, O(1) per frame
+        if (!engine->has_ema) {
+            for (int i = 0; i < 4; ++i) engine->ema[i] = raw[i];
+            engine->has_ema = true;
+        } else {
+            const float a = engine->smoothing_alpha;
+            if (left_open) {
+                engine->ema[0] += a * (raw[0] - engine->ema[0]);
+                engine->ema[1] += a * (raw[1] - engine->ema[1]);
+            }
+            if (right_open) {
+                engine->ema[2] += a * (raw[2] - engine->ema[2]);
+                engine->ema[3] += a * (raw[3] - engine->ema[3]);
+            }
+        }
+    }
+
+    out->left_dx = engine->ema[0];
+    out->left_dy = engine->ema[1];
+    out->right_dx = engine->ema[2];
+    out->right_dy = engine->ema[3];
+
+    if (!left_open && !right_open) {
+        // Full blink: hold the previous decision
+        out->looking = engine->prev_looking;
+    } else {
+        const bool left_ok =
+            !left_open || engine->iris_centered(out->left_dx, out->left_dy);
+        const bool right_ok =
+            !right_open || engine->iris_centered(out->right_dx, out->right_dy);
+        out->looking = (left_ok && right_ok) ? 1 : 0;
+        engine->prev_looking = out->looking;
+    }
+    return 0;
+}
+
+}  // extern "C"
@@ -0,0 +1,105 @@
+"""FaceMesh backend selection.
+
+The solutions-API FaceMesh always runs the TFLite CPU path; there is no
+per-instance delegate hook. What we can control per host is the thread
+budget: XNNPACK/TFLite size their pools from OMP_NUM_THREADS (and
+friends) when the runtime loads, and OpenCV's own pool competes with
+them. autoselect() micro-benchmarks candidate thread counts on synthetic
+frames - each in a fresh spawned subprocess, since the pool sizes
+freeze at first load - and picks the fastest for this host, so FaceMesh
+stops oversubscribing cores we need for capture and serial I/O.
+
+On MediaPipe builds with GPU support, leaving MEDIAPIPE_DISABLE_GPU
+unset lets the graph pick the GPU calculators up; we don't override it.
+
+Thread-budget env vars must be set before the TFLite runtime first
+loads, so call set_thread_budget()/autoselect() before constructing any
+EyeTracker (they import mediapipe lazily for that reason).
+"""
+
+import multiprocessing
+import os
+import queue
+import time
+
+import numpy as np
+
+
+def set_thread_budget(n):
+    """Pin the inference thread budget. Call before mediapipe loads."""
+    n = max(1, int(n))
+    os.environ['OMP_NUM_THREADS'] = str(n)
+    os.environ['TFLITE_NUM_THREADS'] = str(n)
+    try:
+        import cv2
+        cv2.setNumThreads(n)
+    except Exception:
+        pass
+    return n
+
+
+def _make_face_mesh():
+    import mediapipe as mp
+    return mp.solutions.face_mesh.FaceMesh(
+        max_num_faces=1,
+        refine_landmarks=True,
+        min_detection_confidence=0.4,
+        min_tracking_confidence=0.4)
+
+
+def _bench_worker(threads, num_frames, out):
+    """Subprocess entry: pin the budget, then time one candidate.
+
+    Runs in a fresh spawned interpreter because the pool sizes freeze
+    when the TFLite runtime first loads - benching candidates serially
+    in one process would time the first candidate's pools every time.
+    """
+    set_thread_budget(threads)
+    face_mesh = _make_face_mesh()
+    rng = np.random.default_rng(0)
+    frames = [rng.integers(0, 255, (480, 640, 3), dtype=np.uint8)
+              for _ in range(3)]
+    # Warm up graph and model once, outside the timed region
+    face_mesh.process(frames[0])
+    t0 = time.perf_counter()
+    for i in range(num_frames):
+        face_mesh.process(frames[i % len(frames)])
+    dt = time.perf_counter() - t0
+    face_mesh.close()
+    out.put(num_frames / dt)
+
+
+def autoselect(candidates=None, num_frames=15, verbose=True):
+    """Micro-benchmark candidate thread budgets and pin the fastest.
+
+    Returns the chosen thread count. Synthetic noise frames exercise the
+    detector path, which dominates cost and scales the same way as the
+    tracker path with threads. The parent never loads mediapipe here, so
+    the closing set_thread_budget still lands before this process's own
+    TFLite runtime first loads.
+    """
+    cores = os.cpu_count() or 2
+    if candidates is None:
+        candidates = sorted({1, 2, min(4, cores), cores})
+    ctx = multiprocessing.get_context('spawn')
+
+    best_threads, best_fps = candidates[0], 0.0
+    for threads in candidates:
+        out = ctx.Queue()
+        proc = ctx.Process(target=_bench_worker,
+                           args=(threads, num_frames, out), daemon=True)
+        proc.start()
+        try:
+            fps = out.get(timeout=120)
+        except queue.Empty:
+            fps = 0.0  # worker hung or died; never the winner
+        proc.join(timeout=5)
+        if verbose:
+            print(f"backend: {threads} thread(s) -> {fps:.1f} fps")
+        if fps > best_fps:
+            best_threads, best_fps = threads, fps
+
+    set_thread_budget(best_threads)
+    if verbose:
+        print(f"backend: selected {best_threads} thread(s)")
+    return best_threads
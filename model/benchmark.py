@@ -0,0 +1,150 @@
+"""Benchmark harness: replay a recorded frame corpus through the pipeline.
+
+Every performance change to process_frame or the decision logic should
+be gated on this: it replays recorded frames (faces at various angles,
+no-face frames, glasses/occlusion cases) as fast as possible, with no
+camera attached, and reports throughput, per-frame latency percentiles,
+and decision agreement against golden labels.
+
+Corpus layout: a directory of .png/.jpg/.npy frames, replayed in sorted
+filename order, with an optional labels.csv of `filename,looking` rows
+(looking is 1 or 0; frames without a row aren't scored).
+
+Record a corpus from the live camera:
+    python benchmark.py record my_corpus --seconds 30
+Run it:
+    python benchmark.py run my_corpus --repeat 3
+"""
+
+import argparse
+import csv
+import os
+import time
+
+import cv2
+import numpy as np
+
+from eye_tracking_model import EyeTracker
+
+
+def load_corpus(corpus_dir):
+    """Load all frames into memory so disk I/O never skews timings."""
+    frames = []
+    for name in sorted(os.listdir(corpus_dir)):
+        path = os.path.join(corpus_dir, name)
+        if name.endswith('.npy'):
+            frames.append((name, np.load(path)))
+        elif name.lower().endswith(('.png', '.jpg', '.jpeg')):
+            frame = cv2.imread(path)
+            if frame is not None:
+                frames.append((name, frame))
+    return frames
+
+
+def load_labels(corpus_dir):
+    """Golden looking/not-looking labels keyed by frame filename."""
+    path = os.path.join(corpus_dir, 'labels.csv')
+    labels = {}
+    if os.path.exists(path):
+        with open(path, newline='') as f:
+            for row in csv.reader(f):
+                if len(row) >= 2 and row[1].strip() in ('0', '1'):
+                    labels[row[0].strip()] = row[1].strip() == '1'
+    return labels
+
+
+def _percentiles(latencies):
+    data = sorted(latencies)
+    n = len(data)
+    return (data[n // 2],
+            data[min(n - 1, int(n * 0.95))],
+            data[min(n - 1, int(n * 0.99))])
+
+
+def run_benchmark(corpus_dir, repeat=1):
+    frames = load_corpus(corpus_dir)
+    if not frames:
+        print(f"No frames found in {corpus_dir}")
+        return None
+    labels = load_labels(corpus_dir)
+
+    tracker = EyeTracker(use_arduino=False, headless=True)
+    # Warm up the FaceMesh graph so the first-frame cost isn't counted
+    tracker.process_frame(frames[0][1].copy(), time.monotonic())
+
+    latencies = []
+    agree = 0
+    scored = 0
+    t_start = time.perf_counter()
+    for _ in range(repeat):
+        for name, frame in frames:
+            t0 = time.perf_counter()
+            _, looking = tracker.process_frame(frame, time.monotonic())
+            latencies.append(time.perf_counter() - t0)
+            if name in labels:
+                scored += 1
+                if looking == labels[name]:
+                    agree += 1
+    total = time.perf_counter() - t_start
+
+    n = len(latencies)
+    p50, p95, p99 = _percentiles(latencies)
+    print(f"{n} frames in {total:.2f}s  ({n / total:.1f} fps)")
+    print(f"latency p50={p50 * 1e3:.1f}ms p95={p95 * 1e3:.1f}ms "
+          f"p99={p99 * 1e3:.1f}ms")
+    if scored:
+        print(f"decision agreement: {agree}/{scored} "
+              f"({100.0 * agree / scored:.1f}%)")
+    else:
+        print("decision agreement: no golden labels (add labels.csv)")
+    return n / total
+
+
+def record_corpus(corpus_dir, camera_index=0, seconds=30, fps=10):
+    """Grab frames from the live camera into a new corpus directory."""
+    os.makedirs(corpus_dir, exist_ok=True)
+    cap = cv2.VideoCapture(camera_index)
+    if not cap.isOpened():
+        print(f"Could not open camera {camera_index}")
+        return
+    cap.set(cv2.CAP_PROP_FRAME_WIDTH, 640)
+    cap.set(cv2.CAP_PROP_FRAME_HEIGHT, 480)
+    interval = 1.0 / fps
+    count = 0
+    deadline = time.monotonic() + seconds
+    while time.monotonic() < deadline:
+        ret, frame = cap.read()
+        if not ret:
+            break
+        cv2.imwrite(os.path.join(corpus_dir, f"frame_{count:05d}.png"),
+                    cv2.flip(frame, 1))
+        count += 1
+        time.sleep(interval)
+    cap.release()
+    print(f"Recorded {count} frames to {corpus_dir}")
+    print("Label them in labels.csv as `filename,looking` (1 or 0)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest='cmd', required=True)
+
+    p_run = sub.add_parser('run', help='replay a corpus and report stats')
+    p_run.add_argument('corpus')
+    p_run.add_argument('--repeat', type=int, default=1)
+
+    p_rec = sub.add_parser('record', help='record a corpus from the camera')
+    p_rec.add_argument('corpus')
+    p_rec.add_argument('--camera', type=int, default=0)
+    p_rec.add_argument('--seconds', type=int, default=30)
+    p_rec.add_argument('--fps', type=int, default=10)
+
+    args = parser.parse_args()
+    if args.cmd == 'run':
+        run_benchmark(args.corpus, repeat=args.repeat)
+    else:
+        record_corpus(args.corpus, args.camera, args.seconds, args.fps)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,101 @@
+"""Per-user gaze calibration profiles.
+
+The stock 4px/2px thresholds are wrong for about a third of users.
+run_calibration() records a short fixation session (user looks at the
+screen center), fits per-user thresholds from the offset spread, and
+save_profile() persists them as a 16-byte binary record that loads in
+microseconds at startup - no JSON parsing, no restart hand-tuning.
+
+Profile format (little-endian):
+    magic 'GZP1' | version u16 | pad u16 | horizontal f32 | vertical f32
+
+Record a profile:
+    python calibration.py me.gzp --camera 0 --seconds 5
+Use it:
+    EyeTracker(profile='me.gzp')
+"""
+
+import argparse
+import struct
+import time
+
+import numpy as np
+
+MAGIC = b'GZP1'
+VERSION = 1
+_RECORD = struct.Struct('<4sHHff')
+
+
+def save_profile(path, horizontal, vertical):
+    with open(path, 'wb') as f:
+        f.write(_RECORD.pack(MAGIC, VERSION, 0, horizontal, vertical))
+
+
+def load_profile(path):
+    """Load (horizontal, vertical) thresholds. Raises ValueError on a
+    corrupt or unknown profile."""
+    with open(path, 'rb') as f:
+        data = f.read(_RECORD.size)
+    if len(data) != _RECORD.size:
+        raise ValueError("truncated profile")
+    magic, version, _, horizontal, vertical = _RECORD.unpack(data)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a calibration profile")
+    return horizontal, vertical
+
+
+def fit_thresholds(offsets, k=3.0, min_h=2.0, min_v=1.0):
+    """Fit thresholds from fixation offsets: mean magnitude plus k
+    standard deviations per axis, worst eye wins, floored at the minimums
+    so a rock-steady fixation doesn't produce hair-trigger thresholds."""
+    mags = np.abs(np.asarray(offsets, dtype=np.float32))
+    bound = mags.mean(axis=0) + k * mags.std(axis=0)
+    horizontal = max(min_h, float(max(bound[0], bound[2])))
+    vertical = max(min_v, float(max(bound[1], bound[3])))
+    return horizontal, vertical
+
+
+def run_calibration(tracker, cap, seconds=5.0):
+    """Record a fixation session and return fitted (h, v) thresholds.
+    The user should look at the screen center for the whole session."""
+    import cv2
+
+    samples = []
+    deadline = time.monotonic() + seconds
+    while time.monotonic() < deadline:
+        ret, frame = cap.read()
+        if not ret:
+            break
+        offsets = tracker.detect_gaze_offsets(cv2.flip(frame, 1))
+        if offsets is not None:
+            samples.append(offsets)
+    if len(samples) < 10:
+        raise RuntimeError(
+            f"Only {len(samples)} face frames in the session; "
+            "sit centered and retry")
+    return fit_thresholds(samples)
+
+
+def main():
+    from eye_tracking_model import EyeTracker
+
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('profile', help='output profile path')
+    parser.add_argument('--camera', type=int, default=0)
+    parser.add_argument('--seconds', type=float, default=5.0)
+    args = parser.parse_args()
+
+    tracker = EyeTracker(use_arduino=False, headless=True)
+    cap = tracker._open_camera(args.camera)
+    if cap is None:
+        return
+    print(f"Look at the center of the screen for {args.seconds:.0f} seconds...")
+    horizontal, vertical = run_calibration(tracker, cap, args.seconds)
+    cap.release()
+    save_profile(args.profile, horizontal, vertical)
+    print(f"Saved {args.profile}: horizontal={horizontal:.1f}px "
+          f"vertical={vertical:.1f}px")
+
+
+if __name__ == '__main__':
+    main()
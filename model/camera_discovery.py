@@ -0,0 +1,115 @@
+"""Camera discovery with an on-disk cache.
+
+Probing cv2.VideoCapture(i) for i in 0..4 costs 1-3 seconds per failed
+open, so a missing camera used to burn 10+ seconds at startup. Discovery
+now happens once: enumerate devices (via /dev/video* where the platform
+has it, otherwise one bounded probe pass), remember each device's index,
+path, and reported mode in a small JSON cache, and on later startups
+just validate the cache cheaply (device nodes still present) and open
+the right index directly - tens of milliseconds instead of seconds.
+
+Force a re-probe after changing hardware with discover(refresh=True) or
+by deleting the cache file.
+"""
+
+import glob
+import json
+import os
+import sys
+
+CACHE_PATH = os.path.join(os.path.expanduser('~'), '.eyetracker_cameras.json')
+CACHE_VERSION = 1
+
+
+def _platform_device_paths():
+    """Device nodes from the platform, without opening anything."""
+    if sys.platform.startswith('linux'):
+        return sorted(glob.glob('/dev/video*'))
+    return []  # Windows/macOS expose no cheap enumeration; probe instead
+
+
+def probe(max_index=5):
+    """Full (slow) probe: open candidate indices once and record modes."""
+    import cv2
+
+    paths = _platform_device_paths()
+    if paths:
+        # /dev/videoN maps to index N for the default V4L2 backend
+        candidates = []
+        for path in paths:
+            suffix = path.replace('/dev/video', '')
+            if suffix.isdigit():
+                candidates.append((int(suffix), path))
+    else:
+        candidates = [(i, None) for i in range(max_index)]
+
+    cameras = []
+    for index, path in candidates:
+        cap = cv2.VideoCapture(index)
+        if cap.isOpened():
+            cameras.append({
+                'index': index,
+                'path': path,
+                'width': int(cap.get(cv2.CAP_PROP_FRAME_WIDTH)),
+                'height': int(cap.get(cv2.CAP_PROP_FRAME_HEIGHT)),
+                'fps': cap.get(cv2.CAP_PROP_FPS),
+            })
+            cap.release()
+        elif path is None:
+            break  # indices are contiguous when probing blind
+    return cameras
+
+
+def _load_cache():
+    try:
+        with open(CACHE_PATH) as f:
+            data = json.load(f)
+        if data.get('version') == CACHE_VERSION:
+            return data.get('cameras', [])
+    except (OSError, ValueError):
+        pass
+    return None
+
+
+def _save_cache(cameras):
+    try:
+        with open(CACHE_PATH, 'w') as f:
+            json.dump({'version': CACHE_VERSION, 'cameras': cameras}, f)
+    except OSError:
+        pass  # cache is an optimization; never fail startup over it
+
+
+def _validate(cameras):
+    """Cheap check that cached devices still exist (no opens)."""
+    for cam in cameras:
+        if cam.get('path') and not os.path.exists(cam['path']):
+            return False
+    return True
+
+
+def discover(refresh=False):
+    """Return the camera list, from cache when it still validates."""
+    if not refresh:
+        cached = _load_cache()
+        if cached is not None and _validate(cached):
+            return cached
+    cameras = probe()
+    _save_cache(cameras)
+    return cameras
+
+
+def best_index(preferred=None):
+    """Pick the index to open: the preferred one if it's known to exist,
+    else the first discovered camera. None when there are no cameras."""
+    cameras = discover()
+    if not cameras:
+        return None
+    indices = [cam['index'] for cam in cameras]
+    if preferred in indices:
+        return preferred
+    return indices[0]
+
+
+if __name__ == '__main__':
+    for cam in discover(refresh='--refresh' in sys.argv):
+        print(cam)
@@ -0,0 +1,104 @@
+"""Structured event log: fixed-size binary records in an mmap'd ring file.
+
+Auditing week-long deployments through redirected stdout costs a syscall
+per print and gives nothing parseable. EventLog writes each look-away
+event as a fixed 36-byte record into a memory-mapped ring file, so
+logging costs a memcpy into the page cache; the OS flushes lazily. The
+ring wraps, keeping the most recent `capacity` events.
+
+File layout (little-endian):
+    header: magic 'GZL1' | record_size u32 | capacity u32 | next u32
+    then capacity records of:
+        type u8 | stream u8 | pad u16 | seq u32 | ts f64 (epoch) |
+        duration f32 | offsets 4 x f32
+
+Event types: 1 episode start, 2 trigger fired, 3 episode end.
+
+Read a ring offline (CSV on stdout):
+    python event_log.py events.gzl
+"""
+
+import mmap
+import os
+import struct
+import sys
+import time
+
+MAGIC = b'GZL1'
+_HEADER = struct.Struct('<4sIII')
+_RECORD = struct.Struct('<BBHIdf4f')
+
+EPISODE_START = 1
+TRIGGER = 2
+EPISODE_END = 3
+
+_TYPE_NAMES = {EPISODE_START: 'start', TRIGGER: 'trigger', EPISODE_END: 'end'}
+
+
+class EventLog:
+    def __init__(self, path, capacity=65536):
+        self.capacity = capacity
+        size = _HEADER.size + capacity * _RECORD.size
+        new = not os.path.exists(path) or os.path.getsize(path) != size
+        self._f = open(path, 'w+b' if new else 'r+b')
+        if new:
+            self._f.truncate(size)
+        self._mm = mmap.mmap(self._f.fileno(), size)
+        magic, rec_size, cap, self._next = _HEADER.unpack_from(self._mm, 0)
+        if magic != MAGIC or rec_size != _RECORD.size or cap != capacity:
+            # Fresh or incompatible file: initialize the header
+            self._next = 0
+            _HEADER.pack_into(self._mm, 0, MAGIC, _RECORD.size, capacity, 0)
+
+    def log(self, etype, stream=0, duration=0.0, offsets=None):
+        """Append one event. A memcpy into the mapped ring; no syscall."""
+        off = _HEADER.size + (self._next % self.capacity) * _RECORD.size
+        o = offsets if offsets is not None else (0.0, 0.0, 0.0, 0.0)
+        _RECORD.pack_into(self._mm, off, etype, stream, 0, self._next,
+                          time.time(), duration, o[0], o[1], o[2], o[3])
+        self._next += 1
+        struct.pack_into('<I', self._mm, _HEADER.size - 4, self._next)
+
+    def close(self):
+        self._mm.flush()
+        self._mm.close()
+        self._f.close()
+
+
+def read_log(path):
+    """Yield events from a ring file, oldest first."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, rec_size, capacity, next_idx = _HEADER.unpack_from(data, 0)
+    if magic != MAGIC or rec_size != _RECORD.size:
+        raise ValueError("not an event log ring")
+    count = min(next_idx, capacity)
+    start = next_idx - count  # oldest surviving record
+    for i in range(start, next_idx):
+        off = _HEADER.size + (i % capacity) * _RECORD.size
+        (etype, stream, _, seq, ts, duration,
+         o0, o1, o2, o3) = _RECORD.unpack_from(data, off)
+        yield {
+            'type': _TYPE_NAMES.get(etype, str(etype)),
+            'stream': stream,
+            'seq': seq,
+            'ts': ts,
+            'duration': duration,
+            'offsets': (o0, o1, o2, o3),
+        }
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(f"usage: {os.path.basename(sys.argv[0])} <ring-file>")
+        sys.exit(1)
+    print("seq,type,stream,ts,duration,ldx,ldy,rdx,rdy")
+    for ev in read_log(sys.argv[1]):
+        o = ev['offsets']
+        print(f"{ev['seq']},{ev['type']},{ev['stream']},{ev['ts']:.3f},"
+              f"{ev['duration']:.3f},{o[0]:.2f},{o[1]:.2f},{o[2]:.2f},"
+              f"{o[3]:.2f}")
+
+
+if __name__ == '__main__':
+    main()
@@ -1,11 +1,47 @@
 import cv2
 import mediapipe as mp
 import numpy as np
-import serial
 import time
 
+import backend
+import calibration
+import camera_discovery
+import event_log
+import gaze_engine
+import governor
+import pipeline
+import presence_gate
+import profiling
+import serial_link
+import telemetry
+import trigger_policy
+
 class EyeTracker:
-    def __init__(self, arduino_port='COM3', use_arduino=True):
+    # Pixel thresholds for "iris centered in the eye"
+    HORIZONTAL_THRESHOLD = 4
+    VERTICAL_THRESHOLD = 2
+
+    # Eye aspect ratio below this means mid-blink; that eye's offsets
+    # are garbage and get zero weight in the decision
+    EAR_BLINK_THRESHOLD = 0.2
+
+    # Head-pose proxies (in [-1, 1]) beyond which the face is clearly
+    # off-angle and iris offsets add nothing over head orientation
+    FRONTAL_YAW = 0.25
+    FRONTAL_PITCH = 0.3
+
+    def __init__(self, arduino_port='COM3', use_arduino=True, adaptive_roi=True,
+                 headless=False, backend_threads=None, policy=None,
+                 profile=None, use_presence_gate=True, event_log_path=None,
+                 tiered_refine=False, idle_governor=False):
+        # Inference backend: pin the thread budget, or micro-benchmark
+        # the host for the fastest one ('auto'). Most effective when the
+        # first tracker in the process sets it, before TFLite warms up.
+        if backend_threads == 'auto':
+            backend_threads = backend.autoselect()
+        elif backend_threads:
+            backend.set_thread_budget(backend_threads)
+
         # Initialize MediaPipe Face Mesh
         self.mp_face_mesh = mp.solutions.face_mesh
         self.face_mesh = self.mp_face_mesh.FaceMesh(
@@ -15,13 +51,64 @@ class EyeTracker:
             min_tracking_confidence=0.4
         )
         self.mp_drawing = mp.solutions.drawing_utils
-        
+
+        # Tiered refinement: keep a second, un-refined mesh (no iris
+        # pass) and run only that one while the head is clearly off-angle,
+        # where pose alone already decides "not looking". Exactly one mesh
+        # runs per frame; _update_tier picks which with hysteresis.
+        self.tiered_refine = tiered_refine
+        self.base_mesh = None
+        if tiered_refine:
+            self.base_mesh = self.mp_face_mesh.FaceMesh(
+                max_num_faces=1,
+                refine_landmarks=False,
+                min_detection_confidence=0.4,
+                min_tracking_confidence=0.4
+            )
+        self._refine_mode = True
+        self._pose_frontal = True
+
         # Eye landmark indices for MediaPipe Face Mesh
         self.LEFT_EYE = [362, 385, 387, 263, 373, 380]
         self.RIGHT_EYE = [33, 160, 158, 133, 153, 144]
         self.LEFT_IRIS = [474, 475, 476, 477]
         self.RIGHT_IRIS = [469, 470, 471, 472]
-        
+
+        # Precomputed gather indices for the vectorized center computation:
+        # one concatenated index array plus segment starts, so all four
+        # centers come out of a single reduceat over one gathered array.
+        groups = [self.LEFT_EYE, self.RIGHT_EYE, self.LEFT_IRIS, self.RIGHT_IRIS]
+        self._gather_idx = np.concatenate([np.array(g) for g in groups])
+        self._gather_seg = np.cumsum([0] + [len(g) for g in groups[:-1]])
+        self._gather_inv_count = (
+            1.0 / np.array([len(g) for g in groups], dtype=np.float32)
+        ).reshape(-1, 1)
+
+        # Native inference core (landmark math + decision in one call).
+        # Falls back to the pure-Python path if the library isn't built.
+        self.engine = gaze_engine.load()
+        if self.engine:
+            print("Using native gaze_engine")
+        else:
+            print("Native gaze_engine not found, using Python landmark math")
+
+        # Decision thresholds: defaults, or a per-user calibration
+        # profile (16-byte binary, loads in microseconds)
+        self.horizontal_threshold = float(self.HORIZONTAL_THRESHOLD)
+        self.vertical_threshold = float(self.VERTICAL_THRESHOLD)
+        if profile:
+            try:
+                h, v = calibration.load_profile(profile)
+                self.horizontal_threshold = h
+                self.vertical_threshold = v
+                print(f"Loaded calibration profile {profile}: "
+                      f"h={h:.1f}px v={v:.1f}px")
+            except Exception as e:
+                print(f"Warning: could not load profile {profile}: {e}")
+        if self.engine:
+            self.engine.set_thresholds(self.horizontal_threshold,
+                                       self.vertical_threshold)
+
         # Define screen attention zone
         self.looking_at_screen = False
         
@@ -30,31 +117,98 @@ class EyeTracker:
         self.arduino = None
         if self.use_arduino:
             try:
-                self.arduino = serial.Serial(arduino_port, 9600)
-                time.sleep(2)  # Wait for Arduino to reset
+                self.arduino = serial_link.ArduinoLink(arduino_port)
                 print(f"Connected to Arduino on {arduino_port}")
             except Exception as e:
                 print(f"Warning: Could not connect to Arduino: {e}")
                 print("Continuing without Arduino...")
                 self.use_arduino = False
         
+        # Presence gate: cheap downscaled-luma motion check that lets
+        # faceless idle periods skip FaceMesh entirely
+        self.presence_gate = (presence_gate.PresenceGate()
+                              if use_presence_gate else None)
+
+        # Adaptive-resolution mode: once a face is acquired, run FaceMesh
+        # on a padded crop around the previous frame's landmarks instead
+        # of the full frame, falling back to full-frame on tracking loss
+        self.adaptive_roi = adaptive_roi
+        self._roi = None
+        self._roi_pad = 0.4  # padding fraction around the landmark bbox
+
+        # Reused RGB conversion buffers (sized lazily to the frame).
+        # Two buffers so a consumer of the previous frame's RGB view is
+        # never overwritten mid-read by the next conversion.
+        self._rgb_buffers = None
+        self._rgb_index = 0
+
+        # Headless mode: the render path is bound out entirely at init
+        # (no per-frame branching), and the status line goes out over a
+        # UDP telemetry socket instead of the frame overlay
+        self.headless = headless
+        if headless:
+            self.telemetry = telemetry.TelemetryPublisher()
+            self._annotate = self._annotate_noop
+            self._emit_status = self.telemetry.publish
+        else:
+            self.telemetry = None
+            self._annotate = self._annotate_frame
+            self._emit_status = self._emit_noop
+
+        # Temporal smoothing of the gaze offsets (EMA, O(1) per frame) so
+        # single-frame landmark jitter can't flip the decision and reset
+        # the look-away timer. Lets us run inference at 10-15 fps.
+        self.gaze_alpha = 0.4
+        self._gaze_ema = None  # smoothed [left_dx, left_dy, right_dx, right_dy]
+
         # Timer for looking away detection
         self.look_away_start_time = None
         self.look_away_threshold = 0.5  # 0.5 seconds
-        self.signal_sent = False
+        self.signal_sent = False  # mirrors policy.fired, kept for display
+
+        # Structured episode/trigger audit log (mmap'd binary ring)
+        self.event_log = (event_log.EventLog(event_log_path)
+                          if event_log_path else None)
+
+        # Idle-aware frame-rate governor: long stable "looking" periods
+        # drop the loop to a low rate; the first deviating frame ramps
+        # straight back to full rate (battery deployments)
+        self.governor = governor.FrameGovernor() if idle_governor else None
+
+        # Trigger policy: defaults reproduce the old single-shot
+        # behavior; pass a configured TriggerPolicy for repeat fire,
+        # escalation, or bursts
+        self.policy = policy or trigger_policy.TriggerPolicy(
+            look_away_threshold=self.look_away_threshold)
         
-    def get_eye_center(self, landmarks, eye_indices, img_w, img_h):
-        """Calculate the center point of eye landmarks"""
-        x_coords = [landmarks[idx].x * img_w for idx in eye_indices]
-        y_coords = [landmarks[idx].y * img_h for idx in eye_indices]
-        return (int(np.mean(x_coords)), int(np.mean(y_coords)))
-    
-    def get_iris_position(self, landmarks, iris_indices, img_w, img_h):
-        """Get iris center position"""
-        x_coords = [landmarks[idx].x * img_w for idx in iris_indices]
-        y_coords = [landmarks[idx].y * img_h for idx in iris_indices]
-        return (int(np.mean(x_coords)), int(np.mean(y_coords)))
-    
+    def extract_landmarks(self, landmarks):
+        """Pull all landmarks into one contiguous float32 (N, 2) array.
+
+        Done once per frame; everything downstream works on this array
+        instead of touching the landmark protobuf again.
+        """
+        return np.array([(lm.x, lm.y) for lm in landmarks], dtype=np.float32)
+
+    def compute_gaze_features(self, lm_xy, img_w, img_h):
+        """All gaze geometry in one vectorized pass.
+
+        Returns a contiguous float32 (6, 2) array - left eye center,
+        right eye center, left iris center, right iris center, left
+        (dx, dy), right (dx, dy) in pixel coordinates - computed once
+        per frame and read by both the decision layer and the drawing
+        layer instead of being recomputed piecewise.
+        """
+        feats = np.empty((6, 2), dtype=np.float32)
+        pts = np.add.reduceat(lm_xy[self._gather_idx], self._gather_seg, axis=0)
+        pts *= self._gather_inv_count
+        pts[:, 0] *= img_w
+        pts[:, 1] *= img_h
+        feats[:4] = pts
+        feats[4] = pts[2] - pts[0]  # left iris offset from left eye
+        feats[5] = pts[3] - pts[1]  # right iris offset from right eye
+        return feats
+
+
     def calculate_gaze_ratio(self, eye_center, iris_center):
         """Calculate the ratio of iris offset from eye center"""
         dx = iris_center[0] - eye_center[0]
@@ -66,74 +220,267 @@ class EyeTracker:
         """Check if user is looking at screen based on iris-to-eye-center distance"""
         left_dx, left_dy = self.calculate_gaze_ratio(left_eye_center, left_iris)
         right_dx, right_dy = self.calculate_gaze_ratio(right_eye_center, right_iris)
-        
-        # Thresholds for "looking at screen"
-        horizontal_threshold = 4  # pixels
-        vertical_threshold = 2    # pixels
-        
-        # Check if iris is relatively centered in both eyes
-        left_centered = (abs(left_dx) < horizontal_threshold and 
-                        abs(left_dy) < vertical_threshold)   
-        right_centered = (abs(right_dx) < horizontal_threshold and 
-                         abs(right_dy) < vertical_threshold)
-        
+        return self._decide_from_offsets(
+            np.array([left_dx, left_dy, right_dx, right_dy], dtype=np.float32))
+
+    def eye_aspect_ratios(self, lm_xy, img_w, img_h):
+        """Per-eye aspect ratio from the already-extracted landmarks.
+
+        The eye index sets are ordered corner, upper, upper, corner,
+        lower, lower, so the classic EAR formula applies directly - no
+        extra inference, just six distances per eye.
+        """
+        scale = np.array([img_w, img_h], dtype=np.float32)
+
+        def ear(indices):
+            p = lm_xy[indices] * scale
+            v1 = np.linalg.norm(p[1] - p[5])
+            v2 = np.linalg.norm(p[2] - p[4])
+            span = np.linalg.norm(p[0] - p[3])
+            return (v1 + v2) / (2.0 * span) if span > 0 else 0.0
+
+        return ear(self.LEFT_EYE), ear(self.RIGHT_EYE)
+
+    def estimate_head_pose(self, lm_xy):
+        """Cheap yaw/pitch proxies in [-1, 1] from five stable landmarks.
+
+        Yaw compares the nose tip's position between the cheeks; pitch
+        compares it between forehead and chin. Both are ratios of
+        distances within the face, so they are scale- and
+        translation-invariant - no solvePnP, no camera intrinsics.
+        """
+        nose = lm_xy[1]
+        right_cheek = lm_xy[234]
+        left_cheek = lm_xy[454]
+        forehead = lm_xy[10]
+        chin = lm_xy[152]
+        half_w = (left_cheek[0] - right_cheek[0]) / 2.0
+        half_h = (chin[1] - forehead[1]) / 2.0
+        if half_w <= 0 or half_h <= 0:
+            return 0.0, 0.0
+        yaw = (nose[0] - (right_cheek[0] + left_cheek[0]) / 2.0) / half_w
+        pitch = (nose[1] - (forehead[1] + chin[1]) / 2.0) / half_h
+        return float(yaw), float(pitch)
+
+    def _update_tier(self, lm_xy):
+        """Pick which mesh runs next frame from this frame's head pose.
+
+        The hysteresis band (resume at 0.8x the leave thresholds) keeps a
+        head hovering at the edge of the frontal cone from thrashing
+        between the two graphs every frame.
+        """
+        yaw, pitch = self.estimate_head_pose(lm_xy)
+        if self._refine_mode:
+            if (abs(yaw) > self.FRONTAL_YAW or
+                    abs(pitch) > self.FRONTAL_PITCH):
+                self._refine_mode = False
+        elif (abs(yaw) < 0.8 * self.FRONTAL_YAW and
+                abs(pitch) < 0.8 * self.FRONTAL_PITCH):
+            self._refine_mode = True
+        self._pose_frontal = self._refine_mode
+
+    def _decide_from_offsets(self, offsets, left_open=True, right_open=True):
+        """Smooth the raw offsets and apply the thresholds; a blinking
+        eye neither updates its smoothed state nor votes."""
+        if not left_open and not right_open:
+            # Full blink: hold the previous decision
+            return self.looking_at_screen
+
+        if self._gaze_ema is None:
+            self._gaze_ema = offsets.copy()
+        else:
+            if left_open:
+                self._gaze_ema[:2] += self.gaze_alpha * (offsets[:2]
+                                                         - self._gaze_ema[:2])
+            if right_open:
+                self._gaze_ema[2:] += self.gaze_alpha * (offsets[2:]
+                                                         - self._gaze_ema[2:])
+        left_dx, left_dy, right_dx, right_dy = self._gaze_ema
+
+        # Check if iris is relatively centered in each open eye
+        left_centered = (not left_open or
+                         (abs(left_dx) < self.horizontal_threshold and
+                          abs(left_dy) < self.vertical_threshold))
+        right_centered = (not right_open or
+                          (abs(right_dx) < self.horizontal_threshold and
+                           abs(right_dy) < self.vertical_threshold))
+
         return left_centered and right_centered
     
-    def send_arduino_signal(self):
-        """Send trigger signal to Arduino"""
+    def send_arduino_signal(self, count=1):
+        """Queue trigger signal(s) for the Arduino (never blocks the frame loop)"""
         if self.use_arduino and self.arduino:
-            try:
-                self.arduino.write(b'1')
-                print("Signal sent to Arduino!")
-                
-                # Read Arduino response
-                time.sleep(0.1)
-                while self.arduino.in_waiting > 0:
-                    response = self.arduino.readline().decode('utf-8').strip()
-                    print(f"Arduino: {response}")
-                    
-            except Exception as e:
-                print(f"Error sending signal to Arduino: {e}")
+            for _ in range(count):
+                self.arduino.send_fire()
+            print(f"Signal sent to Arduino! (x{count})" if count > 1
+                  else "Signal sent to Arduino!")
     
-    def process_frame(self, frame):
-        """Process a single frame and detect eye position"""
-        img_h, img_w = frame.shape[:2]
-        rgb_frame = cv2.cvtColor(frame, cv2.COLOR_BGR2RGB)
-        results = self.face_mesh.process(rgb_frame)
-        
-        current_time = time.time()
-        
-        if results.multi_face_landmarks:
-            face_landmarks = results.multi_face_landmarks[0]
-            landmarks = face_landmarks.landmark
-            
-            # Get eye centers
-            left_eye_center = self.get_eye_center(landmarks, self.LEFT_EYE, img_w, img_h)
-            right_eye_center = self.get_eye_center(landmarks, self.RIGHT_EYE, img_w, img_h)
-            
-            # Get iris positions
-            left_iris = self.get_iris_position(landmarks, self.LEFT_IRIS, img_w, img_h)
-            right_iris = self.get_iris_position(landmarks, self.RIGHT_IRIS, img_w, img_h)
-            
+    def _to_rgb(self, frame):
+        """Convert BGR to RGB into a reused buffer (no per-frame allocation)"""
+        if self._rgb_buffers is None or self._rgb_buffers[0].shape != frame.shape:
+            self._rgb_buffers = (np.empty_like(frame), np.empty_like(frame))
+        self._rgb_index ^= 1
+        buf = self._rgb_buffers[self._rgb_index]
+        with profiling.stage('cvtcolor'):
+            cv2.cvtColor(frame, cv2.COLOR_BGR2RGB, dst=buf)
+        return buf
+
+    def _update_roi(self, lm_xy, img_w, img_h):
+        """Track a padded bounding box around the landmarks for next frame"""
+        xs = lm_xy[:, 0] * img_w
+        ys = lm_xy[:, 1] * img_h
+        pad_x = (xs.max() - xs.min()) * self._roi_pad
+        pad_y = (ys.max() - ys.min()) * self._roi_pad
+        # Quantize edges so the crop size stays stable and the RGB
+        # conversion buffers actually get reused between frames
+        q = 16
+        x0 = max(0, int(xs.min() - pad_x) // q * q)
+        y0 = max(0, int(ys.min() - pad_y) // q * q)
+        x1 = min(img_w, -(-int(xs.max() + pad_x) // q) * q)
+        y1 = min(img_h, -(-int(ys.max() + pad_y) // q) * q)
+        if x1 - x0 >= q and y1 - y0 >= q:
+            self._roi = (x0, y0, x1, y1)
+        else:
+            self._roi = None
+
+    def _detect_landmarks(self, frame, img_w, img_h):
+        """Run FaceMesh (on the tracked ROI when available) and return the
+        landmark array in full-frame normalized coordinates, or None"""
+        mesh = self.face_mesh
+        if self.tiered_refine and not self._refine_mode:
+            mesh = self.base_mesh
+
+        if self.adaptive_roi and self._roi is not None:
+            x0, y0, x1, y1 = self._roi
+            rgb = self._to_rgb(frame[y0:y1, x0:x1])
+            with profiling.stage('facemesh'):
+                results = mesh.process(rgb)
+            if results.multi_face_landmarks:
+                lm_xy = self.extract_landmarks(
+                    results.multi_face_landmarks[0].landmark)
+                # Map ROI-normalized coords back to full-frame normalized
+                lm_xy[:, 0] = (lm_xy[:, 0] * (x1 - x0) + x0) / img_w
+                lm_xy[:, 1] = (lm_xy[:, 1] * (y1 - y0) + y0) / img_h
+                self._update_roi(lm_xy, img_w, img_h)
+                if self.tiered_refine:
+                    self._update_tier(lm_xy)
+                return lm_xy
+            # Lost the face inside the ROI - retry on the full frame
+            self._roi = None
+
+        rgb = self._to_rgb(frame)
+        with profiling.stage('facemesh'):
+            results = mesh.process(rgb)
+        if not results.multi_face_landmarks:
+            return None
+        lm_xy = self.extract_landmarks(results.multi_face_landmarks[0].landmark)
+        if self.adaptive_roi:
+            self._update_roi(lm_xy, img_w, img_h)
+        if self.tiered_refine:
+            self._update_tier(lm_xy)
+        return lm_xy
+
+    def _annotate_frame(self, frame, centers, status, color):
+        """Draw eye/iris markers and the status line onto the frame"""
+        with profiling.stage('draw'):
+            self._draw(frame, centers, status, color)
+
+    def _draw(self, frame, centers, status, color):
+        if centers is not None:
+            left_eye_center, right_eye_center, left_iris, right_iris = centers
+
             # Draw eye regions
             cv2.circle(frame, left_eye_center, 8, (0, 255, 255), 2)
             cv2.circle(frame, right_eye_center, 8, (0, 255, 255), 2)
-            
+
             # Draw iris positions
             cv2.circle(frame, left_iris, 5, (255, 0, 0), -1)
             cv2.circle(frame, right_iris, 5, (255, 0, 0), -1)
-            
+
             # Draw lines from eye center to iris
             cv2.line(frame, left_eye_center, left_iris, (0, 255, 0), 2)
             cv2.line(frame, right_eye_center, right_iris, (0, 255, 0), 2)
-            
-            # Check if looking at screen
-            self.looking_at_screen = self.is_looking_at_screen(
-                left_eye_center, right_eye_center, 
-                left_iris, right_iris, 
-                frame.shape
-            )
-            
+
+        cv2.putText(frame, status, (10, 30),
+                   cv2.FONT_HERSHEY_SIMPLEX, 1, color, 2)
+
+    def _annotate_noop(self, frame, centers, status, color):
+        pass
+
+    def _emit_noop(self, status):
+        pass
+
+    def detect_gaze_offsets(self, frame):
+        """Detection only, no decision state: return the raw
+        [left_dx, left_dy, right_dx, right_dy] offsets for this frame,
+        or None when no face is found.
+
+        Used by the multi-stream engine, which keeps per-seat smoothing
+        and timer state outside the tracker so workers can be shared.
+        Such trackers should be built with adaptive_roi=False, since the
+        ROI is per-tracker state and would leak between streams.
+        """
+        img_h, img_w = frame.shape[:2]
+        lm_xy = self._detect_landmarks(frame, img_w, img_h)
+        if lm_xy is None:
+            return None
+        feats = self.compute_gaze_features(lm_xy, img_w, img_h)
+        return feats[4:].reshape(4).copy()
+
+    def process_frame(self, frame, capture_ts=None):
+        """Process a single frame and detect eye position.
+
+        capture_ts is the monotonic timestamp taken at the camera; the
+        look-away timer is evaluated against it so the 0.5s threshold
+        stays accurate even when the pipeline stalls or drops frames.
+        Falls back to now when the caller didn't capture one.
+        """
+        img_h, img_w = frame.shape[:2]
+        if self.presence_gate and not self.presence_gate.check(frame):
+            lm_xy = None  # gate asleep: skip FaceMesh entirely
+        else:
+            lm_xy = self._detect_landmarks(frame, img_w, img_h)
+            if lm_xy is not None and self.presence_gate:
+                self.presence_gate.face_seen()
+
+        current_time = capture_ts if capture_ts is not None else time.monotonic()
+
+        if lm_xy is not None:
+            if lm_xy.shape[0] < gaze_engine.NUM_LANDMARKS:
+                # Base-tier frame (un-refined mesh, no iris landmarks):
+                # the head is off-angle, so pose alone is the decision
+                self.looking_at_screen = self._pose_frontal
+                centers = None
+            else:
+                with profiling.stage('landmarks'):
+                    if self.engine:
+                        # One native call computes all features and the
+                        # decision; the result struct is already laid out
+                        # as the (6, 2) feature array
+                        res = self.engine.process_landmarks(lm_xy, img_w,
+                                                            img_h)
+                        feats = np.frombuffer(res, dtype=np.float32,
+                                              count=12).reshape(6, 2)
+                        self.looking_at_screen = bool(res.looking)
+                        # Mirror the engine's smoothed offsets so the
+                        # event-log records carry them on this path too
+                        self._gaze_ema = feats[4:].reshape(4).copy()
+                    else:
+                        # One batched pass computes all features; the
+                        # decision reads the offsets rows
+                        feats = self.compute_gaze_features(lm_xy, img_w,
+                                                           img_h)
+                        lear, rear = self.eye_aspect_ratios(lm_xy, img_w,
+                                                            img_h)
+                        self.looking_at_screen = self._decide_from_offsets(
+                            feats[4:].reshape(4),
+                            left_open=lear >= self.EAR_BLINK_THRESHOLD,
+                            right_open=rear >= self.EAR_BLINK_THRESHOLD)
+
+                ints = feats[:4].astype(int)
+                centers = (tuple(ints[0]), tuple(ints[1]),
+                           tuple(ints[2]), tuple(ints[3]))
+
             # Handle looking away timer
             if not self.looking_at_screen:
                 # Start timer if just looked away
@@ -141,14 +488,22 @@ class EyeTracker:
                     self.look_away_start_time = current_time
                     self.signal_sent = False
                     print("Started looking away...")
+                    if self.event_log:
+                        self.event_log.log(event_log.EPISODE_START,
+                                           offsets=self._gaze_ema)
                 
-                # Check if looked away for 2 seconds
+                # Evaluate the trigger policy against the episode timer
                 elapsed_time = current_time - self.look_away_start_time
-                
-                if elapsed_time >= self.look_away_threshold and not self.signal_sent:
-                    print(f"Looked away for {self.look_away_threshold} seconds!")
-                    self.send_arduino_signal()
+
+                shots = self.policy.update(elapsed_time, current_time)
+                if shots:
+                    print(f"Looked away for {elapsed_time:.1f} seconds!")
+                    self.send_arduino_signal(shots)
                     self.signal_sent = True
+                    if self.event_log:
+                        self.event_log.log(event_log.TRIGGER,
+                                           duration=elapsed_time,
+                                           offsets=self._gaze_ema)
                 
                 # Display timer
                 status = f"Not looking: {elapsed_time:.1f}s"
@@ -156,85 +511,155 @@ class EyeTracker:
                 
             else:
                 # Reset timer when looking at screen
+                if self.look_away_start_time is not None and self.event_log:
+                    self.event_log.log(
+                        event_log.EPISODE_END,
+                        duration=current_time - self.look_away_start_time)
                 self.look_away_start_time = None
                 self.signal_sent = False
+                self.policy.reset()
                 status = "Looking at screen"
                 color = (0, 255, 0)
-            
-            cv2.putText(frame, status, (10, 30), 
-                       cv2.FONT_HERSHEY_SIMPLEX, 1, color, 2)
-            
+
+            self._annotate(frame, centers, status, color)
+            self._emit_status(status)
+
+            if self.governor:
+                self.governor.update(self.looking_at_screen, current_time)
             return frame, self.looking_at_screen
         
-        # No face detected - treat as looking away
+        # No face detected - treat as looking away and clear smoothing state
+        self._gaze_ema = None
+        if self.engine:
+            self.engine.reset()
         if self.look_away_start_time is None:
             self.look_away_start_time = current_time
             self.signal_sent = False
-        
+            if self.event_log:
+                self.event_log.log(event_log.EPISODE_START)
+
         elapsed_time = current_time - self.look_away_start_time
-        if elapsed_time >= self.look_away_threshold and not self.signal_sent:
-            print(f"No face detected for {self.look_away_threshold} seconds!")
-            self.send_arduino_signal()
+        shots = self.policy.update(elapsed_time, current_time)
+        if shots:
+            print(f"No face detected for {elapsed_time:.1f} seconds!")
+            self.send_arduino_signal(shots)
             self.signal_sent = True
+            if self.event_log:
+                self.event_log.log(event_log.TRIGGER, duration=elapsed_time)
         
-        cv2.putText(frame, f"No face: {elapsed_time:.1f}s", (10, 30), 
-                   cv2.FONT_HERSHEY_SIMPLEX, 1, (0, 0, 255), 2)
+        status = f"No face: {elapsed_time:.1f}s"
+        self._annotate(frame, None, status, (0, 0, 255))
+        self._emit_status(status)
+        if self.governor:
+            self.governor.update(False, current_time)
         return frame, False
     
-    def run(self, camera_index=1):
-        """Main loop to run the eye tracker"""
+    def _open_camera(self, camera_index):
+        """Open and configure the camera, or return None on failure"""
+        # Resolve through the discovery cache first: warm starts skip
+        # the multi-second per-index probing entirely
+        index = camera_discovery.best_index(preferred=camera_index)
+        if index is None:
+            print("Error: no cameras found (cache and probe both empty)")
+            return None
+        if index != camera_index:
+            print(f"Camera index {camera_index} not present, "
+                  f"using discovered index {index}")
+
         # Try to open camera with different backends
-        cap = cv2.VideoCapture(camera_index, cv2.CAP_DSHOW)
-        
+        cap = cv2.VideoCapture(index, cv2.CAP_DSHOW)
+
         if not cap.isOpened():
-            print(f"Trying camera index {camera_index} with default backend...")
-            cap = cv2.VideoCapture(camera_index)
-        
+            print(f"Trying camera index {index} with default backend...")
+            cap = cv2.VideoCapture(index)
+
         if not cap.isOpened():
-            print(f"Error: Could not open camera at index {camera_index}")
-            print("Trying to find available cameras...")
-            for i in range(5):
-                test_cap = cv2.VideoCapture(i)
-                if test_cap.isOpened():
-                    print(f"Found camera at index {i}, change the camera_index variable")
-                    test_cap.release()
-                else:
-                    break
-            return
-        
+            # Stale cache (device unplugged since last probe): re-probe
+            print(f"Error: Could not open camera at index {index}, re-probing...")
+            cameras = camera_discovery.discover(refresh=True)
+            if not cameras:
+                print("No cameras found")
+                return None
+            cap = cv2.VideoCapture(cameras[0]['index'])
+            if not cap.isOpened():
+                print(f"Error: Could not open camera at index "
+                      f"{cameras[0]['index']}")
+                return None
+
         # Set camera properties
         cap.set(cv2.CAP_PROP_FRAME_WIDTH, 640)
         cap.set(cv2.CAP_PROP_FRAME_HEIGHT, 480)
-        
-        # Give camera time to warm up
-        time.sleep(1)
-        
+
+        # Poll for the first real frame instead of a fixed warm-up sleep
+        deadline = time.monotonic() + 2.0
+        while time.monotonic() < deadline:
+            ret, _ = cap.read()
+            if ret:
+                break
+        return cap
+
+    def run_pipelined(self, camera_index=1, render=None):
+        """Run with capture/inference/render on separate threads"""
+        if render is None:
+            render = not self.headless
+        cap = self._open_camera(camera_index)
+        if cap is None:
+            return
+
+        print("Eye Tracker started (pipelined). Press 'q' to quit.")
+        print(f"Camera opened successfully at index {camera_index}")
+
+        pipeline.Pipeline(self, cap, render=render).run()
+
+        cap.release()
+
+        # Close Arduino connection
+        if self.arduino:
+            self.arduino.close()
+            print("Arduino connection closed")
+
+    def run(self, camera_index=1):
+        """Main loop to run the eye tracker"""
+        cap = self._open_camera(camera_index)
+        if cap is None:
+            return
+
         print("Eye Tracker started. Press 'q' to quit.")
         print(f"Camera opened successfully at index {camera_index}")
         if self.use_arduino:
             print("Arduino signal will be sent after 2 seconds of looking away")
         
         while True:
-            ret, frame = cap.read()
+            with profiling.stage('capture'):
+                ret, frame = cap.read()
+            capture_ts = time.monotonic()
             if not ret:
                 print("Error: Could not read frame")
                 break
-            
+
             # Flip frame horizontally for mirror view
             frame = cv2.flip(frame, 1)
-            
-            # Process the frame
-            processed_frame, looking = self.process_frame(frame)
-            
-            # Display the frame
-            cv2.imshow('Eye Tracker', processed_frame)
-            
-            # Exit on 'q' key
-            if cv2.waitKey(1) & 0xFF == ord('q'):
-                break
-        
+
+            # Process the frame against its capture time
+            processed_frame, looking = self.process_frame(frame, capture_ts)
+
+            # Idle cap: stretch stable-looking frames to the idle rate
+            if self.governor:
+                self.governor.throttle(capture_ts)
+
+            # Display the frame (headless mode never touches the GUI)
+            if not self.headless:
+                cv2.imshow('Eye Tracker', processed_frame)
+
+                # Exit on 'q' key
+                if cv2.waitKey(1) & 0xFF == ord('q'):
+                    break
+
         cap.release()
-        cv2.destroyAllWindows()
+        if not self.headless:
+            cv2.destroyAllWindows()
+        if self.telemetry:
+            self.telemetry.close()
         
         # Close Arduino connection
         if self.arduino:
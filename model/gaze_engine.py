@@ -0,0 +1,103 @@
+"""ctypes binding for the native gaze_engine library.
+
+Build the library with:
+    cmake -S engine -B engine/build && cmake --build engine/build
+
+If the shared library is not found, load() returns None and the tracker
+falls back to the pure-Python landmark math.
+"""
+
+import ctypes
+import os
+
+NUM_LANDMARKS = 478
+
+
+class GazeResult(ctypes.Structure):
+    _fields_ = [
+        ("left_eye_x", ctypes.c_float), ("left_eye_y", ctypes.c_float),
+        ("right_eye_x", ctypes.c_float), ("right_eye_y", ctypes.c_float),
+        ("left_iris_x", ctypes.c_float), ("left_iris_y", ctypes.c_float),
+        ("right_iris_x", ctypes.c_float), ("right_iris_y", ctypes.c_float),
+        ("left_dx", ctypes.c_float), ("left_dy", ctypes.c_float),
+        ("right_dx", ctypes.c_float), ("right_dy", ctypes.c_float),
+        ("looking", ctypes.c_int),
+        ("left_ear", ctypes.c_float), ("right_ear", ctypes.c_float),
+    ]
+
+
+def _library_candidates():
+    """Places we look for the built library, in order."""
+    override = os.environ.get("GAZE_ENGINE_LIB")
+    if override:
+        yield override
+    here = os.path.dirname(os.path.abspath(__file__))
+    build_dir = os.path.join(here, "..", "engine", "build")
+    for name in ("libgaze_engine.so", "libgaze_engine.dylib", "gaze_engine.dll"):
+        yield os.path.join(build_dir, name)
+
+
+class GazeEngine:
+    """Thin wrapper around one native engine instance."""
+
+    def __init__(self, lib):
+        self._lib = lib
+        self._handle = lib.ge_create()
+        self._result = GazeResult()
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            self._lib.ge_destroy(self._handle)
+            self._handle = None
+
+    def process_landmarks(self, landmarks_xy, img_w, img_h):
+        """Run the full landmark->decision path in one native call.
+
+        landmarks_xy is a contiguous float32 array of 478 normalized (x, y)
+        pairs. Returns the GazeResult struct (reused between calls).
+        """
+        ptr = landmarks_xy.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+        rc = self._lib.ge_process_landmarks(
+            self._handle, ptr, NUM_LANDMARKS, img_w, img_h,
+            ctypes.byref(self._result))
+        if rc != 0:
+            raise ValueError("ge_process_landmarks failed")
+        return self._result
+
+    def set_smoothing(self, alpha):
+        """Set the EMA factor for the decision offsets (1.0 disables)."""
+        self._lib.ge_set_smoothing(self._handle, ctypes.c_float(alpha))
+
+    def reset(self):
+        """Clear temporal state; call when the face is lost."""
+        self._lib.ge_reset(self._handle)
+
+    def set_thresholds(self, horizontal, vertical):
+        """Override the decision thresholds (calibration profiles)."""
+        self._lib.ge_set_thresholds(self._handle, ctypes.c_float(horizontal),
+                                    ctypes.c_float(vertical))
+
+def load():
+    """Load the native engine, or return None if it isn't built."""
+    for path in _library_candidates():
+        if not os.path.exists(path):
+            continue
+        lib = ctypes.CDLL(path)
+        lib.ge_create.restype = ctypes.c_void_p
+        lib.ge_create.argtypes = []
+        lib.ge_destroy.restype = None
+        lib.ge_destroy.argtypes = [ctypes.c_void_p]
+        lib.ge_set_smoothing.restype = None
+        lib.ge_set_smoothing.argtypes = [ctypes.c_void_p, ctypes.c_float]
+        lib.ge_reset.restype = None
+        lib.ge_reset.argtypes = [ctypes.c_void_p]
+        lib.ge_set_thresholds.restype = None
+        lib.ge_set_thresholds.argtypes = [ctypes.c_void_p, ctypes.c_float,
+                                          ctypes.c_float]
+        lib.ge_process_landmarks.restype = ctypes.c_int
+        lib.ge_process_landmarks.argtypes = [
+            ctypes.c_void_p, ctypes.POINTER(ctypes.c_float),
+            ctypes.c_int, ctypes.c_int, ctypes.c_int,
+            ctypes.POINTER(GazeResult)]
+        return GazeEngine(lib)
+    return None
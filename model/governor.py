@@ -0,0 +1,55 @@
+"""Idle-aware frame-rate governor.
+
+The run() loop captures and infers flat-out regardless of state, so
+tracking someone who has been steadily looking at the screen burns the
+same CPU as active look-away detection - on battery kiosks that is the
+difference between 3 and 8 hours of runtime. The governor watches the
+smoothed decision: after settle_after seconds of uninterrupted
+"looking" it caps the loop at idle_fps, and the first deviating frame
+snaps it back to full rate. The worst case added to detection latency
+is one idle-rate frame interval (200ms at the default 5fps), well
+inside the 0.5s look-away threshold.
+
+State updates (update) and the enforcing sleep (throttle) are split so
+the pipelined mode can throttle on the capture thread while the
+decision lives on the inference thread.
+"""
+
+import time
+
+
+class FrameGovernor:
+    def __init__(self, idle_fps=5.0, settle_after=3.0):
+        self.idle_interval = 1.0 / idle_fps
+        self.settle_after = settle_after
+        self._stable_since = None
+        self.idle = False
+
+    def update(self, looking, now=None):
+        """Fold one frame's decision in. Returns the idle state."""
+        if now is None:
+            now = time.monotonic()
+        if looking:
+            if self._stable_since is None:
+                self._stable_since = now
+            self.idle = now - self._stable_since >= self.settle_after
+        else:
+            # A single deviating frame ramps straight back to full rate
+            self._stable_since = None
+            self.idle = False
+        return self.idle
+
+    def throttle(self, frame_start=None):
+        """Sleep out the rest of the idle frame interval, if idling.
+
+        frame_start is when this frame's capture happened; the sleep
+        tops the frame up to the idle interval rather than adding a full
+        interval on top of the processing time.
+        """
+        if not self.idle:
+            return
+        now = time.monotonic()
+        delay = (frame_start if frame_start is not None
+                 else now) + self.idle_interval - now
+        if delay > 0:
+            time.sleep(delay)
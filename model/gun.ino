@@ -1,33 +1,243 @@
 #include <Servo.h>
 
-Servo myServo;  // Create servo object
+Servo myServo;  // Fire servo
+Servo panServo;
+Servo tiltServo;
 
-const int servoPin = 13;  // Pin connected to servo
+const int servoPin = 13;   // Pin connected to fire servo
+const int panPin = 10;
+const int tiltPin = 11;
+const int restAngle = 50;  // Neutral position
+const int fireAngle = 110; // Fire position
+
+// Fire cycle timing (was two blocking delay(500) calls)
+const unsigned long fireHoldMs = 500;    // hold at fire position
+const unsigned long returnHoldMs = 500;  // settle back at neutral
+
+// --- Binary framed protocol, 115200 baud ---
+// Frame: 0xA5 | opcode | payload_len | payload... | crc8(opcode+len+payload)
+// Must match model/serial_link.py.
+const unsigned long LINK_BAUD = 115200;
+const byte FRAME_SYNC = 0xA5;
+
+// Host -> device opcodes
+const byte OP_FIRE = 0x01;
+const byte OP_PING = 0x02;
+const byte OP_BATCH = 0x03;  // seq | N x (device, value u16 LE)
+
+// Device -> host opcodes
+const byte OP_READY = 0x80;
+const byte OP_ACK_FIRE_START = 0x81;
+const byte OP_ACK_FIRE_DONE = 0x82;
+const byte OP_PONG = 0x83;
+const byte OP_ACK_BATCH = 0x84;  // echoes the batch seq
+
+// Addressable devices in batch commands
+const byte DEV_PAN = 0;
+const byte DEV_TILT = 1;
+const byte DEV_FIRE = 2;
+
+const byte MAX_PAYLOAD = 16;  // fits seq + 5 batch commands
+
+// Non-blocking fire state machine: loop() never blocks, so serial
+// bytes are consumed the moment they arrive even mid-cycle.
+enum FireState { IDLE, FIRING, RETURNING };
+FireState fireState = IDLE;
+unsigned long stateStart = 0;
+
+// Triggers that arrive mid-cycle are queued (coalesced beyond the cap)
+// and fired back-to-back at the servo's mechanical rate.
+byte pendingTriggers = 0;
+const byte maxPendingTriggers = 3;
+
+// Incremental frame parser state
+enum RxState { RX_SYNC, RX_OPCODE, RX_LEN, RX_PAYLOAD, RX_CRC };
+RxState rxState = RX_SYNC;
+byte rxOpcode = 0;
+byte rxLen = 0;
+byte rxPayload[MAX_PAYLOAD];
+byte rxGot = 0;
+byte rxCrc = 0;
+
+byte crc8Update(byte crc, byte data) {
+  crc ^= data;
+  for (byte i = 0; i < 8; i++) {
+    if (crc & 0x80) {
+      crc = (crc << 1) ^ 0x07;
+    } else {
+      crc <<= 1;
+    }
+  }
+  return crc;
+}
+
+void sendFrameU32(byte opcode, unsigned long value);
+
+void sendFrame(byte opcode, const byte *payload, byte len) {
+  byte crc = 0;
+  crc = crc8Update(crc, opcode);
+  crc = crc8Update(crc, len);
+  Serial.write(FRAME_SYNC);
+  Serial.write(opcode);
+  Serial.write(len);
+  for (byte i = 0; i < len; i++) {
+    crc = crc8Update(crc, payload[i]);
+    Serial.write(payload[i]);
+  }
+  Serial.write(crc);
+}
+
+// Ack carrying the local millis() clock, so the host can measure true
+// fire-start/fire-complete timing against its own trigger timestamps
+void sendFrameU32(byte opcode, unsigned long value) {
+  byte payload[4];
+  payload[0] = value & 0xFF;
+  payload[1] = (value >> 8) & 0xFF;
+  payload[2] = (value >> 16) & 0xFF;
+  payload[3] = (value >> 24) & 0xFF;
+  sendFrame(opcode, payload, 4);
+}
+
+void requestFire() {
+  if (fireState == IDLE) {
+    startFire();
+  } else if (pendingTriggers < maxPendingTriggers) {
+    pendingTriggers++;
+  }
+  // Triggers beyond the queue cap coalesce into the last pending one
+}
+
+// Apply one batch of addressed commands. Position writes take effect
+// immediately - the fire cycle is a state machine, not a delay, so a
+// pan/tilt update never waits behind it.
+void handleBatch(const byte *payload, byte len) {
+  if (len < 1) {
+    return;
+  }
+  byte seq = payload[0];
+  for (byte off = 1; off + 3 <= len; off += 3) {
+    byte device = payload[off];
+    unsigned int value = payload[off + 1] | ((unsigned int)payload[off + 2] << 8);
+    switch (device) {
+      case DEV_PAN:
+        panServo.write(constrain(value, 0, 180));
+        break;
+      case DEV_TILT:
+        tiltServo.write(constrain(value, 0, 180));
+        break;
+      case DEV_FIRE:
+        requestFire();  // value carries the host's channel; unused here
+        break;
+      default:
+        break;  // unknown device, skip
+    }
+  }
+  sendFrame(OP_ACK_BATCH, &seq, 1);
+}
+
+void handleFrame(byte opcode, const byte *payload, byte len) {
+  switch (opcode) {
+    case OP_FIRE:
+      requestFire();
+      break;
+    case OP_PING:
+      sendFrame(OP_PONG, 0, 0);
+      break;
+    case OP_BATCH:
+      handleBatch(payload, len);
+      break;
+    default:
+      break;  // unknown opcode, ignore
+  }
+}
+
+void feedParser(byte b) {
+  switch (rxState) {
+    case RX_SYNC:
+      if (b == FRAME_SYNC) {
+        rxState = RX_OPCODE;
+      } else if (b == '1') {
+        requestFire();  // legacy text-protocol trigger
+      }
+      break;
+    case RX_OPCODE:
+      rxOpcode = b;
+      rxCrc = crc8Update(0, b);
+      rxState = RX_LEN;
+      break;
+    case RX_LEN:
+      rxLen = b;
+      rxCrc = crc8Update(rxCrc, b);
+      rxGot = 0;
+      if (rxLen > MAX_PAYLOAD) {
+        rxState = RX_SYNC;  // oversized, drop the frame
+      } else {
+        rxState = (rxLen > 0) ? RX_PAYLOAD : RX_CRC;
+      }
+      break;
+    case RX_PAYLOAD:
+      rxPayload[rxGot++] = b;
+      rxCrc = crc8Update(rxCrc, b);
+      if (rxGot >= rxLen) {
+        rxState = RX_CRC;
+      }
+      break;
+    case RX_CRC:
+      if (b == rxCrc) {
+        handleFrame(rxOpcode, rxPayload, rxLen);
+      }
+      rxState = RX_SYNC;  // bad CRC frames are silently dropped
+      break;
+  }
+}
+
+void startFire() {
+  sendFrameU32(OP_ACK_FIRE_START, millis());
+  myServo.write(fireAngle);  // Move to fire position
+  fireState = FIRING;
+  stateStart = millis();
+}
 
 void setup() {
-  Serial.begin(9600);            // Start serial communication at 9600 baud
-  myServo.attach(servoPin);      // Attach servo to pin 9
-  myServo.write(50);             // Start at rest position (60 degrees)
-  Serial.println("Servo ready!");
-  delay(1000);
+  Serial.begin(LINK_BAUD);       // High-speed binary link
+  myServo.attach(servoPin);      // Attach fire servo to pin 13
+  myServo.write(restAngle);      // Start at rest position
+  panServo.attach(panPin);
+  tiltServo.attach(tiltPin);
+  panServo.write(90);            // Aim straight ahead
+  tiltServo.write(90);
+  sendFrame(OP_READY, 0, 0);     // Announce early so the host can proceed
+  delay(1000);                   // Let the servo reach rest
 }
 
 void loop() {
-  // Check if data is available from serial
-  if (Serial.available() > 0) {
-    char input = Serial.read();  // Read the incoming byte
+  // Consume serial input immediately, even while a cycle is running
+  while (Serial.available() > 0) {
+    feedParser((byte)Serial.read());
+  }
 
-     if (input == '\n' || input == '\r') {
-      return;
-    }
+  unsigned long now = millis();
+  switch (fireState) {
+    case IDLE:
+      break;
 
-      Serial.println(" - FIRE!");
-      myServo.write(110);  // Move to fire position
-      delay(500);          // Hold position
-      myServo.write(50);   // Return to neutral
-      delay(500);
-    
-    
-    Serial.println("Complete. Ready for next trigger...");
+    case FIRING:
+      if (now - stateStart >= fireHoldMs) {
+        myServo.write(restAngle);  // Return to neutral
+        fireState = RETURNING;
+        stateStart = now;
+      }
+      break;
+
+    case RETURNING:
+      if (now - stateStart >= returnHoldMs) {
+        sendFrameU32(OP_ACK_FIRE_DONE, millis());
+        fireState = IDLE;
+        if (pendingTriggers > 0) {
+          pendingTriggers--;
+          startFire();
+        }
+      }
+      break;
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,224 @@
+"""Multi-face tracking from one wide camera.
+
+The single-seat tracker hard-codes max_num_faces=1 and reads
+multi_face_landmarks[0]. The lobby build watches up to six people with
+one camera instead: FaceMesh returns every face, the landmark math runs
+once over an (N, 478, 2) tensor - per-face cost is a numpy slice, not a
+Python loop - and each face carries its own smoothing, look-away timer,
+and trigger state (a SeatState, same as the multi-camera engine uses).
+
+Faces keep their identity between frames by greedy nearest-centroid
+matching in normalized coordinates, so a timer follows its person while
+they move through the frame; a face unseen for a short grace period is
+dropped and its episode ends.
+"""
+
+import time
+
+import cv2
+import mediapipe as mp
+import numpy as np
+
+import multi_stream
+import profiling
+import serial_link
+
+# Landmark index sets, same as EyeTracker / the native engine, but
+# concatenated for one gather across all faces at once
+_GROUPS = [
+    [362, 385, 387, 263, 373, 380],  # left eye
+    [33, 160, 158, 133, 153, 144],   # right eye
+    [474, 475, 476, 477],            # left iris
+    [469, 470, 471, 472],            # right iris
+]
+_GATHER_IDX = np.concatenate([np.array(g) for g in _GROUPS])
+_GATHER_SEG = np.cumsum([0] + [len(g) for g in _GROUPS[:-1]])
+_INV_COUNT = (1.0 / np.array([len(g) for g in _GROUPS],
+                             dtype=np.float32)).reshape(-1, 1)
+
+NUM_LANDMARKS = 478
+
+
+def extract_all(multi_face_landmarks):
+    """All faces' landmarks as one contiguous float32 (N, 478, 2) tensor."""
+    lm = np.empty((len(multi_face_landmarks), NUM_LANDMARKS, 2),
+                  dtype=np.float32)
+    for i, face in enumerate(multi_face_landmarks):
+        lm[i] = [(p.x, p.y) for p in face.landmark]
+    return lm
+
+
+def compute_features(lm, img_w, img_h):
+    """Gaze features for every face in one vectorized pass.
+
+    lm is the (N, 478, 2) normalized landmark tensor; returns a float32
+    (N, 6, 2) array laid out per face like the single-seat path: left
+    eye center, right eye center, left iris, right iris, left (dx, dy),
+    right (dx, dy), all in pixel coordinates.
+    """
+    pts = np.add.reduceat(lm[:, _GATHER_IDX, :], _GATHER_SEG, axis=1)
+    pts *= _INV_COUNT
+    pts[..., 0] *= img_w
+    pts[..., 1] *= img_h
+    feats = np.empty((lm.shape[0], 6, 2), dtype=np.float32)
+    feats[:, :4] = pts
+    feats[:, 4] = pts[:, 2] - pts[:, 0]  # left iris offset from left eye
+    feats[:, 5] = pts[:, 3] - pts[:, 1]  # right iris offset from right eye
+    return feats
+
+
+class _Track:
+    """One tracked person: identity anchor plus their decision state."""
+
+    def __init__(self, track_id, centroid, now):
+        self.track_id = track_id
+        self.centroid = centroid  # normalized (x, y), for association
+        self.last_seen = now
+        self.seat = multi_stream.SeatState(track_id, channel=track_id & 0xFF)
+
+
+class MultiFaceTracker:
+    # A detection further than this (normalized units) from every track
+    # is a new person, not the same one moved
+    MATCH_RADIUS = 0.15
+
+    # Drop a track not matched for this long; brief occlusions survive
+    DROP_AFTER = 1.0  # seconds
+
+    def __init__(self, max_faces=6, arduino_port=None, use_arduino=False,
+                 headless=False):
+        self.mp_face_mesh = mp.solutions.face_mesh
+        self.face_mesh = self.mp_face_mesh.FaceMesh(
+            max_num_faces=max_faces,
+            refine_landmarks=True,
+            min_detection_confidence=0.4,
+            min_tracking_confidence=0.4
+        )
+        self.headless = headless
+
+        self.arduino = None
+        self.use_arduino = use_arduino
+        if use_arduino:
+            try:
+                self.arduino = serial_link.ArduinoLink(arduino_port)
+                print(f"Connected to Arduino on {arduino_port}")
+            except Exception as e:
+                print(f"Warning: Could not connect to Arduino: {e}")
+                self.use_arduino = False
+
+        self.tracks = []
+        self._next_id = 0
+
+    def _associate(self, centroids, now):
+        """Match detections to tracks, greedy nearest-centroid first.
+
+        Returns the track for each detection (new tracks for unmatched
+        detections) and retires tracks unseen past the grace period.
+        """
+        assigned = [None] * len(centroids)
+        free_tracks = list(self.tracks)
+        pairs = [(np.hypot(*(c - t.centroid)), di, t)
+                 for di, c in enumerate(centroids) for t in free_tracks]
+        for dist, di, track in sorted(pairs, key=lambda p: p[0]):
+            if dist > self.MATCH_RADIUS:
+                break
+            if assigned[di] is None and track in free_tracks:
+                assigned[di] = track
+                free_tracks.remove(track)
+
+        for di, track in enumerate(assigned):
+            if track is None:
+                track = _Track(self._next_id, centroids[di], now)
+                self._next_id += 1
+                self.tracks.append(track)
+                assigned[di] = track
+            track.centroid = centroids[di]
+            track.last_seen = now
+
+        self.tracks = [t for t in self.tracks
+                       if now - t.last_seen < self.DROP_AFTER]
+        return assigned
+
+    def process_frame(self, frame, capture_ts=None):
+        """Detect all faces, update every person's timer, fire as needed.
+
+        Returns the (annotated) frame and the list of (track_id, looking)
+        pairs for the faces seen this frame.
+        """
+        img_h, img_w = frame.shape[:2]
+        now = capture_ts if capture_ts is not None else time.monotonic()
+
+        rgb = cv2.cvtColor(frame, cv2.COLOR_BGR2RGB)
+        with profiling.stage('facemesh'):
+            results = self.face_mesh.process(rgb)
+        if not results.multi_face_landmarks:
+            # Everyone left the frame: let the grace period expire tracks
+            self.tracks = [t for t in self.tracks
+                           if now - t.last_seen < self.DROP_AFTER]
+            if not self.headless:
+                cv2.putText(frame, "No faces", (10, 30),
+                            cv2.FONT_HERSHEY_SIMPLEX, 1, (0, 0, 255), 2)
+            return frame, []
+
+        with profiling.stage('landmarks'):
+            lm = extract_all(results.multi_face_landmarks)
+            feats = compute_features(lm, img_w, img_h)
+
+        # Identity anchor: midpoint of the two eye centers, normalized
+        scale = np.array([img_w, img_h], dtype=np.float32)
+        centroids = feats[:, :2].mean(axis=1) / scale
+
+        states = []
+        for di, track in enumerate(self._associate(centroids, now)):
+            offsets = feats[di, 4:].reshape(4)
+            fire = track.seat.update(offsets, now)
+            if fire and self.arduino:
+                self.arduino.send_fire(channel=track.seat.channel)
+            states.append((track.track_id, track.seat.looking))
+            if not self.headless:
+                self._draw_face(frame, feats[di], track)
+        return frame, states
+
+    def _draw_face(self, frame, face_feats, track):
+        centers = face_feats[:4].astype(int)
+        color = (0, 255, 0) if track.seat.looking else (0, 0, 255)
+        cv2.circle(frame, tuple(centers[0]), 8, (0, 255, 255), 2)
+        cv2.circle(frame, tuple(centers[1]), 8, (0, 255, 255), 2)
+        cv2.circle(frame, tuple(centers[2]), 5, (255, 0, 0), -1)
+        cv2.circle(frame, tuple(centers[3]), 5, (255, 0, 0), -1)
+        label_at = (int(centers[0][0]), int(centers[0][1]) - 20)
+        cv2.putText(frame, f"#{track.track_id}", label_at,
+                    cv2.FONT_HERSHEY_SIMPLEX, 0.6, color, 2)
+
+    def run(self, camera_index=0):
+        """Main loop for the wide-camera lobby deployment."""
+        cap = cv2.VideoCapture(camera_index)
+        if not cap.isOpened():
+            print(f"Error: Could not open camera at index {camera_index}")
+            return
+        cap.set(cv2.CAP_PROP_FRAME_WIDTH, 1280)
+        cap.set(cv2.CAP_PROP_FRAME_HEIGHT, 720)
+
+        print("Multi-face tracker started. Press 'q' to quit.")
+        while True:
+            ret, frame = cap.read()
+            capture_ts = time.monotonic()
+            if not ret:
+                print("Error: Could not read frame")
+                break
+            frame = cv2.flip(frame, 1)
+            self.process_frame(frame, capture_ts)
+            if not self.headless:
+                cv2.imshow('Multi-Face Tracker', frame)
+                if cv2.waitKey(1) & 0xFF == ord('q'):
+                    break
+
+        cap.release()
+        if not self.headless:
+            cv2.destroyAllWindows()
+        if self.arduino:
+            self.arduino.close()
+
+
+if __name__ == "__main__":
+    MultiFaceTracker(max_faces=6, use_arduino=False).run(camera_index=0)
@@ -0,0 +1,176 @@
+"""Multi-camera / multi-seat tracking with a shared inference worker pool.
+
+Watching four seats with four full EyeTracker pipelines would mean four
+FaceMesh instances saturating a 4-core box. Instead, MultiStreamEngine
+owns N capture sources (one cheap capture thread each, feeding a
+newest-frame slot) and schedules their frames across a small pool of
+inference workers, each owning one FaceMesh. Decision state - smoothing,
+look-away timer, trigger flag - lives per seat, not per worker, so any
+worker can process any seat's frame. Triggers go out on the shared
+Arduino link addressed with the seat's channel.
+"""
+
+import os
+import queue
+import threading
+import time
+
+import numpy as np
+
+import pipeline
+import serial_link
+from eye_tracking_model import EyeTracker
+
+
+class SeatState:
+    """Per-seat smoothing, look-away timer, and trigger state."""
+
+    def __init__(self, stream_id, channel, look_away_threshold=0.5, alpha=0.4):
+        self.stream_id = stream_id
+        self.channel = channel
+        self.look_away_threshold = look_away_threshold
+        self.alpha = alpha
+        self._ema = None
+        self.look_away_start_time = None
+        self.signal_sent = False
+        self.looking = False
+        self._lock = threading.Lock()
+
+    def update(self, offsets, now):
+        """Fold one frame's raw offsets (or None for no face) into the
+        seat state. Returns True when the trigger should fire."""
+        with self._lock:
+            if offsets is None:
+                self._ema = None
+                self.looking = False
+            else:
+                if self._ema is None:
+                    self._ema = offsets.astype(np.float32)
+                else:
+                    self._ema += self.alpha * (offsets - self._ema)
+                left_dx, left_dy, right_dx, right_dy = self._ema
+                self.looking = (
+                    abs(left_dx) < EyeTracker.HORIZONTAL_THRESHOLD and
+                    abs(left_dy) < EyeTracker.VERTICAL_THRESHOLD and
+                    abs(right_dx) < EyeTracker.HORIZONTAL_THRESHOLD and
+                    abs(right_dy) < EyeTracker.VERTICAL_THRESHOLD)
+
+            if self.looking:
+                self.look_away_start_time = None
+                self.signal_sent = False
+                return False
+
+            if self.look_away_start_time is None:
+                self.look_away_start_time = now
+                self.signal_sent = False
+                print(f"Seat {self.stream_id}: started looking away...")
+                return False
+
+            elapsed = now - self.look_away_start_time
+            if elapsed >= self.look_away_threshold and not self.signal_sent:
+                self.signal_sent = True
+                print(f"Seat {self.stream_id}: looked away for "
+                      f"{self.look_away_threshold} seconds!")
+                return True
+            return False
+
+
+class MultiStreamEngine:
+    def __init__(self, camera_indices, arduino_port=None, num_workers=None):
+        self.camera_indices = list(camera_indices)
+        if num_workers is None:
+            # One FaceMesh per core saturates the box; leave headroom
+            # for capture and serial threads
+            num_workers = max(1, min(len(self.camera_indices),
+                                     (os.cpu_count() or 2) - 1))
+        self.num_workers = num_workers
+
+        self.arduino = None
+        if arduino_port:
+            try:
+                self.arduino = serial_link.ArduinoLink(arduino_port)
+            except Exception as e:
+                print(f"Warning: Could not connect to Arduino: {e}")
+
+        self.seats = [SeatState(i, channel=i)
+                      for i in range(len(self.camera_indices))]
+        self._slots = [pipeline.LatestSlot() for _ in self.camera_indices]
+        self._ready = queue.Queue()  # stream ids with a fresh frame
+        self._stop = threading.Event()
+        self._threads = []
+
+    def _capture_loop(self, stream_id, cam_index):
+        import cv2
+        cap = cv2.VideoCapture(cam_index)
+        if not cap.isOpened():
+            print(f"Seat {stream_id}: could not open camera {cam_index}")
+            return
+        cap.set(cv2.CAP_PROP_FRAME_WIDTH, 640)
+        cap.set(cv2.CAP_PROP_FRAME_HEIGHT, 480)
+        while not self._stop.is_set():
+            ret, frame = cap.read()
+            if not ret:
+                print(f"Seat {stream_id}: camera read failed")
+                break
+            self._slots[stream_id].put((frame, time.monotonic()))
+            self._ready.put(stream_id)
+        cap.release()
+
+    def _worker_loop(self):
+        # Each worker owns its own FaceMesh; adaptive ROI is disabled
+        # because that state is per-tracker and frames from different
+        # seats interleave here
+        tracker = EyeTracker(use_arduino=False, adaptive_roi=False,
+                             headless=True)
+        while not self._stop.is_set():
+            try:
+                stream_id = self._ready.get(timeout=0.5)
+            except queue.Empty:
+                continue
+            item = self._slots[stream_id].get(timeout=0)
+            if item is None:
+                continue  # a sibling worker already took a fresher frame
+            frame, capture_ts = item
+            offsets = tracker.detect_gaze_offsets(frame)
+            # Evaluate the look-away timer against capture time, not now
+            fire = self.seats[stream_id].update(offsets, capture_ts)
+            if fire and self.arduino:
+                self.arduino.send_fire(channel=self.seats[stream_id].channel)
+
+    def start(self):
+        for i, cam in enumerate(self.camera_indices):
+            t = threading.Thread(target=self._capture_loop, args=(i, cam),
+                                 daemon=True)
+            self._threads.append(t)
+        for _ in range(self.num_workers):
+            t = threading.Thread(target=self._worker_loop, daemon=True)
+            self._threads.append(t)
+        for t in self._threads:
+            t.start()
+        print(f"Tracking {len(self.camera_indices)} seats "
+              f"on {self.num_workers} inference workers")
+
+    def stop(self):
+        self._stop.set()
+        for slot in self._slots:
+            slot.close()
+        for t in self._threads:
+            t.join(timeout=2)
+        if self.arduino:
+            self.arduino.close()
+
+    def run(self):
+        """Start and block until interrupted."""
+        self.start()
+        try:
+            while not self._stop.is_set():
+                time.sleep(0.5)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            self.stop()
+
+
+if __name__ == "__main__":
+    # Example: four seats on cameras 0-3, triggers on one shared board
+    MultiStreamEngine([0, 1, 2, 3], arduino_port='COM3').run()
@@ -0,0 +1,132 @@
+"""Threaded capture/inference/render pipeline for the eye tracker.
+
+The serial run() loop pays camera read latency plus inference latency on
+every frame. Here each stage runs on its own thread connected by
+single-slot hand-offs that always hold the newest frame: when inference
+falls behind, older frames are overwritten (dropped), never queued, so
+the decision always runs on the freshest capture.
+
+Stage layout:
+    capture thread -> LatestSlot -> inference thread -> LatestSlot -> render (main thread)
+
+Render is optional; without it the main thread just waits for shutdown.
+"""
+
+import threading
+import time
+
+import cv2
+
+import profiling
+
+
+class LatestSlot:
+    """Single-item hand-off that keeps only the newest item.
+
+    put() overwrites any unconsumed item (counted as a drop), so a slow
+    consumer never builds a backlog of stale frames.
+    """
+
+    def __init__(self):
+        self._cond = threading.Condition()
+        self._item = None
+        self._has_item = False
+        self._closed = False
+        self.dropped = 0
+
+    def put(self, item):
+        with self._cond:
+            if self._has_item:
+                self.dropped += 1
+            self._item = item
+            self._has_item = True
+            self._cond.notify()
+
+    def get(self, timeout=0.5):
+        """Return the newest item, or None on timeout/close."""
+        with self._cond:
+            if not self._has_item and not self._closed:
+                self._cond.wait(timeout)
+            if not self._has_item:
+                return None
+            item = self._item
+            self._item = None
+            self._has_item = False
+            return item
+
+    def close(self):
+        with self._cond:
+            self._closed = True
+            self._cond.notify_all()
+
+
+class Pipeline:
+    """Runs an EyeTracker over a capture source with pipelined stages."""
+
+    def __init__(self, tracker, cap, render=True):
+        self.tracker = tracker
+        self.cap = cap
+        self.render = render
+        self.stop_event = threading.Event()
+        self._raw_slot = LatestSlot()
+        self._out_slot = LatestSlot()
+
+    def _capture_loop(self):
+        while not self.stop_event.is_set():
+            with profiling.stage('capture'):
+                ret, frame = self.cap.read()
+            capture_ts = time.monotonic()  # timestamp at the camera
+            if not ret:
+                print("Error: Could not read frame")
+                self.stop_event.set()
+                break
+            # Flip frame horizontally for mirror view
+            self._raw_slot.put((cv2.flip(frame, 1), capture_ts))
+            # Idle cap: the governor's state is updated on the inference
+            # thread; the enforcing sleep belongs here so an idle period
+            # stops the capture burn too
+            if self.tracker.governor:
+                self.tracker.governor.throttle(capture_ts)
+        self._raw_slot.close()
+
+    def _inference_loop(self):
+        while not self.stop_event.is_set():
+            item = self._raw_slot.get()
+            if item is None:
+                continue
+            frame, capture_ts = item
+            processed_frame, looking = self.tracker.process_frame(frame, capture_ts)
+            if self.render:
+                self._out_slot.put(processed_frame)
+        self._out_slot.close()
+
+    def run(self):
+        """Run until the camera fails or the user presses 'q'."""
+        threads = [
+            threading.Thread(target=self._capture_loop, daemon=True),
+            threading.Thread(target=self._inference_loop, daemon=True),
+        ]
+        for t in threads:
+            t.start()
+
+        try:
+            # Render stays on the calling thread (imshow requirement)
+            while not self.stop_event.is_set():
+                if self.render:
+                    frame = self._out_slot.get()
+                    if frame is not None:
+                        cv2.imshow('Eye Tracker', frame)
+                    if cv2.waitKey(1) & 0xFF == ord('q'):
+                        break
+                else:
+                    self.stop_event.wait(0.5)
+        finally:
+            self.stop_event.set()
+            self._raw_slot.close()
+            self._out_slot.close()
+            for t in threads:
+                t.join(timeout=2)
+            if self.render:
+                cv2.destroyAllWindows()
+            if self._raw_slot.dropped:
+                print(f"Dropped {self._raw_slot.dropped} frames to stay fresh")
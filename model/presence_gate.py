@@ -0,0 +1,62 @@
+"""Cheap face-presence gate in front of FaceMesh.
+
+Idle kiosks sit faceless for hours, yet every frame used to pay full
+FaceMesh cost just to conclude "No face". PresenceGate runs first on a
+160x120 luma plane: frame differencing against a slowly-adapting
+background. FaceMesh only runs while the gate is awake; motion (someone
+walking up) wakes it on the very next frame, and hysteresis keeps it
+awake for a while after the last motion or face so the start of a
+look-away episode is never missed. Asleep cost is a resize, a gray
+conversion, and a mean over 19200 pixels - roughly two orders of
+magnitude under a FaceMesh pass.
+"""
+
+import cv2
+import numpy as np
+
+
+class PresenceGate:
+    def __init__(self, wake_threshold=4.0, sleep_after=90, size=(160, 120)):
+        self.wake_threshold = wake_threshold  # mean abs luma delta to wake
+        self.sleep_after = sleep_after        # quiet frames before sleeping
+        self.size = size
+        self.awake = True  # start awake so startup never misses a face
+        self._background = None
+        self._quiet_frames = 0
+        self._small = None
+        self._gray = None
+
+    def check(self, frame):
+        """Update from one frame; returns True when FaceMesh should run."""
+        if self._small is None:
+            self._small = np.empty((self.size[1], self.size[0], 3),
+                                   dtype=frame.dtype)
+            self._gray = np.empty((self.size[1], self.size[0]),
+                                  dtype=frame.dtype)
+        cv2.resize(frame, self.size, dst=self._small,
+                   interpolation=cv2.INTER_AREA)
+        cv2.cvtColor(self._small, cv2.COLOR_BGR2GRAY, dst=self._gray)
+        gray = self._gray.astype(np.float32)
+
+        if self._background is None:
+            self._background = gray.copy()
+            return self.awake
+
+        score = float(np.mean(np.abs(gray - self._background)))
+        # Slow background adaptation so lighting drift doesn't wake us
+        self._background += 0.05 * (gray - self._background)
+
+        if score > self.wake_threshold:
+            self.awake = True
+            self._quiet_frames = 0
+        else:
+            self._quiet_frames += 1
+            if self.awake and self._quiet_frames >= self.sleep_after:
+                self.awake = False
+        return self.awake
+
+    def face_seen(self):
+        """A face was just detected; a motionless user must not put the
+        gate to sleep mid-episode."""
+        self._quiet_frames = 0
+        self.awake = True
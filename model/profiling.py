@@ -0,0 +1,128 @@
+"""Per-stage latency instrumentation for the pipeline.
+
+Wrap each stage boundary in `with profiling.stage('facemesh'):` and get
+p50/p95/p99 per stage, dumped as a single stats line every few seconds.
+Disabled by default; toggle at runtime with enable()/disable() or start
+with PROFILE=1 in the environment. When disabled, stage() is one boolean
+check returning a shared no-op context manager, so the instrumented code
+pays effectively nothing.
+
+Stage names in use: capture, cvtcolor, facemesh, landmarks, draw, serial.
+"""
+
+import os
+import threading
+import time
+
+
+class _Histogram:
+    """Ring of recent latency samples; percentiles computed at dump time."""
+
+    SIZE = 512
+
+    __slots__ = ('samples', 'idx', 'count')
+
+    def __init__(self):
+        self.samples = [0.0] * self.SIZE
+        self.idx = 0
+        self.count = 0
+
+    def add(self, dt):
+        self.samples[self.idx] = dt
+        self.idx = (self.idx + 1) % self.SIZE
+        self.count += 1
+
+    def percentiles(self):
+        n = min(self.count, self.SIZE)
+        if n == 0:
+            return None
+        data = sorted(self.samples[:n])
+        return (data[n // 2],
+                data[min(n - 1, int(n * 0.95))],
+                data[min(n - 1, int(n * 0.99))])
+
+
+class _NoopTimer:
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        return False
+
+
+_NOOP = _NoopTimer()
+
+
+class _StageTimer:
+    __slots__ = ('_profiler', '_name', '_t0')
+
+    def __init__(self, profiler, name):
+        self._profiler = profiler
+        self._name = name
+
+    def __enter__(self):
+        self._t0 = time.perf_counter()
+        return self
+
+    def __exit__(self, *exc):
+        self._profiler._record(self._name, time.perf_counter() - self._t0)
+        return False
+
+
+class Profiler:
+    def __init__(self, dump_interval=5.0):
+        self.enabled = os.environ.get('PROFILE', '') == '1'
+        self.dump_interval = dump_interval
+        self._hists = {}
+        self._lock = threading.Lock()
+        self._last_dump = time.monotonic()
+
+    def enable(self):
+        self.enabled = True
+
+    def disable(self):
+        self.enabled = False
+
+    def stage(self, name):
+        """Context manager timing one stage. No-op while disabled."""
+        if not self.enabled:
+            return _NOOP
+        return _StageTimer(self, name)
+
+    def record(self, name, dt):
+        """Record an externally-timed sample (e.g. a serial round trip)."""
+        if self.enabled:
+            self._record(name, dt)
+
+    def _record(self, name, dt):
+        with self._lock:
+            hist = self._hists.get(name)
+            if hist is None:
+                hist = self._hists[name] = _Histogram()
+            hist.add(dt)
+        now = time.monotonic()
+        if now - self._last_dump >= self.dump_interval:
+            self._last_dump = now
+            self.dump()
+
+    def dump(self):
+        """Print one stats line: per-stage p50/p95/p99 in milliseconds."""
+        parts = []
+        with self._lock:
+            for name in sorted(self._hists):
+                p = self._hists[name].percentiles()
+                if p:
+                    parts.append(
+                        f"{name} p50={p[0] * 1e3:.1f} "
+                        f"p95={p[1] * 1e3:.1f} p99={p[2] * 1e3:.1f}ms")
+        if parts:
+            print("prof: " + " | ".join(parts))
+
+
+# Shared instance; all pipeline code uses these
+profiler = Profiler()
+stage = profiler.stage
+record = profiler.record
+enable = profiler.enable
+disable = profiler.disable
+dump = profiler.dump
@@ -0,0 +1,350 @@
+"""Non-blocking serial I/O to the Arduino.
+
+send_arduino_signal used to sleep 100ms and drain responses inline,
+stalling the frame loop on every trigger. ArduinoLink moves all serial
+traffic off the hot path: send() just enqueues the command for a writer
+thread, and a reader thread consumes Arduino responses as they arrive.
+Disconnects are handled by a background reconnect loop so a yanked USB
+cable never takes down the frame loop.
+
+The link runs a compact binary framed protocol at 115200 baud:
+
+    0xA5 | opcode | payload_len | payload... | crc8
+
+with CRC-8 (poly 0x07) over opcode+len+payload. Commands to the three
+turret servos (pan, tilt, fire) travel as addressed batches: everything
+queued within one transmit window goes out in a single OP_BATCH frame,
+redundant position updates for the same device coalesce to the newest
+value, and each batch is matched against its sequence-numbered ack - so
+a 60Hz pan/tilt stream shares the link with fire triggers without
+head-of-line blocking behind the slow fire cycle. At connect time the host
+pings at 115200; if no PONG comes back it falls back to the legacy
+9600-baud text link ('1' trigger byte, println responses) so old
+firmware keeps working.
+"""
+
+import collections
+import queue
+import struct
+import threading
+import time
+
+import serial
+
+import profiling
+
+# --- Framed protocol ---
+FRAME_SYNC = 0xA5
+LINK_BAUD = 115200
+LEGACY_BAUD = 9600
+
+# Host -> device opcodes
+OP_FIRE = 0x01
+OP_PING = 0x02
+OP_BATCH = 0x03
+
+# Device -> host opcodes
+OP_READY = 0x80
+OP_ACK_FIRE_START = 0x81
+OP_ACK_FIRE_DONE = 0x82
+OP_PONG = 0x83
+OP_ACK_BATCH = 0x84
+
+# Addressable devices on the board, for batch commands
+DEV_PAN = 0
+DEV_TILT = 1
+DEV_FIRE = 2
+
+# Batch payload is seq + 3 bytes per command; the firmware's parser
+# buffer caps the frame, so the host chunks longer batches
+MAX_BATCH_COMMANDS = 5
+
+_OPCODE_NAMES = {
+    OP_READY: "READY",
+    OP_ACK_FIRE_START: "FIRE_START",
+    OP_ACK_FIRE_DONE: "FIRE_DONE",
+    OP_PONG: "PONG",
+    OP_ACK_BATCH: "BATCH_ACK",
+}
+
+
+def crc8(data):
+    """CRC-8, poly 0x07, init 0x00. Must match the firmware."""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            if crc & 0x80:
+                crc = ((crc << 1) ^ 0x07) & 0xFF
+            else:
+                crc = (crc << 1) & 0xFF
+    return crc
+
+
+def make_frame(opcode, payload=b''):
+    body = bytes([opcode, len(payload)]) + payload
+    return bytes([FRAME_SYNC]) + body + bytes([crc8(body)])
+
+
+class FrameParser:
+    """Incremental parser for the framed protocol (reader-thread side)."""
+
+    def __init__(self):
+        self._buf = bytearray()
+
+    def feed(self, data):
+        """Consume bytes, yield (opcode, payload) for each valid frame."""
+        self._buf.extend(data)
+        frames = []
+        while True:
+            # Resync on the sync byte
+            while self._buf and self._buf[0] != FRAME_SYNC:
+                self._buf.pop(0)
+            if len(self._buf) < 4:
+                return frames
+            payload_len = self._buf[2]
+            frame_len = 4 + payload_len
+            if len(self._buf) < frame_len:
+                return frames
+            body = bytes(self._buf[1:3 + payload_len])
+            if crc8(body) == self._buf[frame_len - 1]:
+                frames.append((self._buf[1], body[2:]))
+                del self._buf[:frame_len]
+            else:
+                # Bad CRC: skip the sync byte and resync
+                self._buf.pop(0)
+
+
+class ArduinoLink:
+    def __init__(self, port, reset_delay=2.0):
+        self.port = port
+        self._serial = None
+        self.binary = False
+        self._parser = FrameParser()
+        self._open(reset_delay)
+
+        self._commands = queue.Queue()
+        # Trigger latency measurement: host send times of in-flight fire
+        # commands, matched FIFO against the firmware's timestamped acks
+        self._fire_sent = collections.deque(maxlen=32)
+        self._fw_start_ms = collections.deque(maxlen=32)
+        # In-flight batches: seq -> send time, matched against BATCH_ACK
+        self._batch_seq = 0
+        self._inflight = {}
+        self._stop = threading.Event()
+        self._lock = threading.Lock()  # guards reconnects
+        self._writer = threading.Thread(target=self._writer_loop, daemon=True)
+        self._reader = threading.Thread(target=self._reader_loop, daemon=True)
+        self._writer.start()
+        self._reader.start()
+
+    def _open(self, reset_delay):
+        """Open the port, negotiating the high-speed binary link first.
+
+        reset_delay bounds how long we poll for the firmware's boot
+        READY frame; a board that announces itself early lets startup
+        continue immediately instead of serving a fixed sleep.
+        """
+        port = serial.Serial(self.port, LINK_BAUD, timeout=0.1)
+        # Firmware sends READY when it finishes booting; poll for it
+        if self._await_ready(port, reset_delay):
+            self._serial = port
+            self.binary = True
+            print(f"Binary link up at {LINK_BAUD} baud")
+            return
+        # No boot banner (board may already be running): ping it
+        port.write(make_frame(OP_PING))
+        if self._await_ready(port, 1.0):
+            self._serial = port
+            self.binary = True
+            print(f"Binary link up at {LINK_BAUD} baud")
+            return
+        # Old firmware: fall back to the legacy text link. Its boot
+        # banner is "Servo ready!"; poll for any line, bounded.
+        port.close()
+        port = serial.Serial(self.port, LEGACY_BAUD, timeout=0.1)
+        deadline = time.monotonic() + reset_delay
+        while time.monotonic() < deadline:
+            if port.readline():
+                break
+        self._serial = port
+        print(f"Falling back to legacy text link at {LEGACY_BAUD} baud")
+
+    @staticmethod
+    def _await_ready(port, timeout):
+        """Poll for a READY/PONG frame, returning as soon as one arrives."""
+        parser = FrameParser()
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            for opcode, _ in parser.feed(port.read(64)):
+                if opcode in (OP_PONG, OP_READY):
+                    return True
+        return False
+
+    @property
+    def connected(self):
+        return self._serial is not None
+
+    def send(self, data):
+        """Queue raw bytes for the writer thread. Never blocks."""
+        self._commands.put(data)
+
+    def send_fire(self, channel=0):
+        """Queue a fire trigger. On the binary link it rides the next
+        batch frame; channel addresses the stream/seat that triggered
+        (the legacy text link has no addressing and ignores it)."""
+        self._commands.put(('fire', channel))
+
+    def send_position(self, device, angle):
+        """Queue a servo position update (DEV_PAN or DEV_TILT).
+
+        Updates for the same device queued within one transmit window
+        coalesce to the newest value, so a 60Hz aim stream never backs
+        up behind the fire cycle. Binary link only; the legacy firmware
+        has no positionable servos.
+        """
+        if self.binary:
+            self._commands.put(('pos', device, angle))
+
+    def close(self):
+        self._stop.set()
+        self._commands.put(None)  # wake the writer
+        self._writer.join(timeout=2)
+        self._reader.join(timeout=2)
+        if self._serial:
+            self._serial.close()
+            self._serial = None
+
+    def _reconnect(self):
+        """Drop the dead port and retry with backoff until it comes back."""
+        with self._lock:
+            if self._serial:
+                try:
+                    self._serial.close()
+                except Exception:
+                    pass
+                self._serial = None
+        delay = 0.5
+        while not self._stop.is_set():
+            try:
+                self._open(reset_delay=2.0)
+                print(f"Reconnected to Arduino on {self.port}")
+                return
+            except Exception:
+                self._stop.wait(delay)
+                delay = min(delay * 2, 5.0)
+
+    def _make_batch(self, commands):
+        """One sequence-numbered OP_BATCH frame carrying N commands."""
+        self._batch_seq = (self._batch_seq + 1) & 0xFF
+        payload = bytearray([self._batch_seq])
+        for device, value in commands:
+            payload += struct.pack('<BH', device, int(value) & 0xFFFF)
+        if len(self._inflight) >= 64:  # acks lost across a reconnect
+            self._inflight.pop(next(iter(self._inflight)))
+        self._inflight[self._batch_seq] = time.monotonic()
+        return make_frame(OP_BATCH, bytes(payload))
+
+    def _writer_loop(self):
+        while not self._stop.is_set():
+            item = self._commands.get()
+            if item is None:
+                continue
+            # Coalescing window: everything already queued goes out in
+            # this transmit. Position updates collapse to the newest
+            # value per device; every fire stays distinct.
+            items = [item]
+            try:
+                while True:
+                    items.append(self._commands.get_nowait())
+            except queue.Empty:
+                pass
+
+            positions = {}
+            fires = []
+            raw = []
+            for it in items:
+                if it is None:
+                    continue
+                if isinstance(it, tuple):
+                    if it[0] == 'pos':
+                        positions[it[1]] = it[2]
+                    else:
+                        fires.append(it[1])
+                else:
+                    raw.append(it)
+
+            try:
+                with self._lock:
+                    port = self._serial
+                if port is None:
+                    continue  # drop commands while disconnected
+                with profiling.stage('serial'):
+                    for data in raw:
+                        port.write(data)
+                    if self.binary:
+                        commands = (list(positions.items())
+                                    + [(DEV_FIRE, ch) for ch in fires])
+                        for i in range(0, len(commands), MAX_BATCH_COMMANDS):
+                            chunk = commands[i:i + MAX_BATCH_COMMANDS]
+                            port.write(self._make_batch(chunk))
+                    else:
+                        for _ in fires:
+                            port.write(b'1')
+                if fires:
+                    # Timestamp after the bytes hit the driver, so the
+                    # round trip covers link + firmware, not our queue
+                    now = time.monotonic()
+                    for _ in fires:
+                        self._fire_sent.append(now)
+            except Exception as e:
+                print(f"Serial write failed: {e}")
+                self._reconnect()
+
+    def _handle_frame(self, opcode, payload):
+        now = time.monotonic()
+        if opcode == OP_ACK_BATCH:
+            if payload:
+                sent = self._inflight.pop(payload[0], None)
+                if sent is not None:
+                    profiling.record('batch_rtt', now - sent)
+            return  # at 60Hz these would flood the console
+        if opcode == OP_ACK_FIRE_START:
+            # Trigger byte sent -> servo starts moving
+            if self._fire_sent:
+                profiling.record('trigger_rtt', now - self._fire_sent[0])
+            if len(payload) >= 4:
+                self._fw_start_ms.append(struct.unpack('<I', payload[:4])[0])
+        elif opcode == OP_ACK_FIRE_DONE:
+            # Full cycle as seen from the host
+            if self._fire_sent:
+                profiling.record('trigger_cycle',
+                                 now - self._fire_sent.popleft())
+            # And as timed by the firmware's own clock (no link jitter)
+            if len(payload) >= 4 and self._fw_start_ms:
+                fw_ms = (struct.unpack('<I', payload[:4])[0]
+                         - self._fw_start_ms.popleft())
+                profiling.record('fire_cycle_fw', fw_ms / 1000.0)
+        name = _OPCODE_NAMES.get(opcode, f"0x{opcode:02x}")
+        print(f"Arduino: {name}")
+
+    def _reader_loop(self):
+        while not self._stop.is_set():
+            with self._lock:
+                port = self._serial
+            if port is None:
+                time.sleep(0.2)
+                continue
+            try:
+                if self.binary:
+                    data = port.read(64)
+                    for opcode, payload in self._parser.feed(data):
+                        self._handle_frame(opcode, payload)
+                else:
+                    line = port.readline()
+                    if line:
+                        response = line.decode('utf-8', errors='replace').strip()
+                        if response:
+                            print(f"Arduino: {response}")
+            except Exception:
+                time.sleep(0.2)  # writer thread owns reconnecting
@@ -0,0 +1,274 @@
+"""Shared-memory frame transport for out-of-process inference.
+
+MediaPipe occasionally crashes on malformed USB frames; running it in
+the same process as the serial/trigger logic takes the gun offline with
+it. IsolatedTracker splits the pipeline: the capture+decision process
+owns the camera, the look-away timer, and the Arduino link; a separate
+inference process runs FaceMesh. Frames cross over a ring of
+preallocated shared-memory slots - a memcpy in, a memcpy out, no
+pickling or sockets - and results come back through a small
+shared-memory block. If the inference process dies it is respawned
+immediately; the decision state never leaves the capture side, so no
+episode is lost.
+
+Frame ring layout (single-producer, single-consumer, freshest-wins):
+    [0:8)  latest_seq (uint64), updated after the slot is complete
+    then SLOT_COUNT slots of: seq u64 | ts f64 | h i32 | w i32 | pixels
+
+A reader copies the newest slot and re-checks its seq afterwards; a
+mismatch means the writer lapped it and the frame is simply skipped.
+"""
+
+import struct
+import time
+from multiprocessing import Event, Process, shared_memory
+
+import numpy as np
+
+SLOT_COUNT = 4
+_SLOT_HEADER = struct.Struct('<QdiI')  # seq, ts, h, w
+_RESULT = struct.Struct('<Qdi4f')      # seq, ts, has_face, offsets
+
+
+class FrameRing:
+    def __init__(self, name=None, create=False, width=640, height=480):
+        self.width = width
+        self.height = height
+        self.frame_bytes = width * height * 3
+        self.slot_bytes = _SLOT_HEADER.size + self.frame_bytes
+        size = 8 + SLOT_COUNT * self.slot_bytes
+        self.shm = shared_memory.SharedMemory(name=name, create=create,
+                                              size=size)
+        self.name = self.shm.name
+        self._seq = 0
+
+    def _slot_off(self, seq):
+        return 8 + (seq % SLOT_COUNT) * self.slot_bytes
+
+    def publish(self, frame, ts):
+        """Copy one frame into the next slot. Producer side only."""
+        self._seq += 1
+        off = self._slot_off(self._seq)
+        buf = self.shm.buf
+        # Invalidate the slot first so a racing reader detects the overwrite
+        struct.pack_into('<Q', buf, off, 0)
+        h, w = frame.shape[:2]
+        data_off = off + _SLOT_HEADER.size
+        dst = np.frombuffer(buf, dtype=np.uint8, count=h * w * 3,
+                            offset=data_off).reshape(h, w, 3)
+        np.copyto(dst, frame)
+        _SLOT_HEADER.pack_into(buf, off, self._seq, ts, h, w)
+        struct.pack_into('<Q', buf, 0, self._seq)
+
+    def latest(self, last_seen):
+        """Copy out the newest frame if it's newer than last_seen.
+        Returns (seq, ts, frame) or None."""
+        buf = self.shm.buf
+        (latest,) = struct.unpack_from('<Q', buf, 0)
+        if latest <= last_seen:
+            return None
+        off = self._slot_off(latest)
+        seq, ts, h, w = _SLOT_HEADER.unpack_from(buf, off)
+        if seq != latest:
+            return None  # writer is mid-overwrite
+        data_off = off + _SLOT_HEADER.size
+        frame = np.frombuffer(buf, dtype=np.uint8, count=h * w * 3,
+                              offset=data_off).reshape(h, w, 3).copy()
+        (seq_after,) = struct.unpack_from('<Q', buf, off)
+        if seq_after != latest:
+            return None  # lapped during the copy
+        return seq, ts, frame
+
+    def close(self):
+        self.shm.close()
+
+    def unlink(self):
+        self.shm.unlink()
+
+
+class ResultBlock:
+    """Newest inference result: seq, capture ts, has_face, dx/dy offsets."""
+
+    def __init__(self, name=None, create=False):
+        self.shm = shared_memory.SharedMemory(name=name, create=create,
+                                              size=_RESULT.size)
+        self.name = self.shm.name
+
+    def publish(self, seq, ts, offsets):
+        if offsets is None:
+            _RESULT.pack_into(self.shm.buf, 0, seq, ts, 0, 0, 0, 0, 0)
+        else:
+            _RESULT.pack_into(self.shm.buf, 0, seq, ts, 1, *offsets)
+
+    def latest(self, last_seen):
+        fields = _RESULT.unpack_from(self.shm.buf, 0)
+        seq, ts, has_face = fields[0], fields[1], fields[2]
+        if seq <= last_seen:
+            return None
+        offsets = np.array(fields[3:], dtype=np.float32) if has_face else None
+        return seq, ts, offsets
+
+    def close(self):
+        self.shm.close()
+
+    def unlink(self):
+        self.shm.unlink()
+
+
+def inference_worker(ring_name, result_name, width, height, start=None):
+    """Entry point of the inference process.
+
+    `start`, when given, makes this a warm spare: the process builds its
+    tracker, primes the FaceMesh graph, then parks on the event until the
+    supervisor promotes it.
+    """
+    from eye_tracking_model import EyeTracker
+
+    ring = FrameRing(name=ring_name, width=width, height=height)
+    results = ResultBlock(name=result_name)
+    tracker = EyeTracker(use_arduino=False, headless=True)
+    # Graph construction is lazy: the first process() call pays the model
+    # deserialization and tensor allocation (seconds on kiosk hardware).
+    # Prime with a blank frame so that cost is paid here, before the
+    # process is ever on the hot path.
+    tracker.detect_gaze_offsets(np.zeros((height, width, 3), dtype=np.uint8))
+    if start is not None:
+        start.wait()
+    last_seen = 0
+    try:
+        while True:
+            item = ring.latest(last_seen)
+            if item is None:
+                time.sleep(0.001)
+                continue
+            seq, ts, frame = item
+            last_seen = seq
+            results.publish(seq, ts, tracker.detect_gaze_offsets(frame))
+    finally:
+        ring.close()
+        results.close()
+
+
+class WarmPool:
+    """Pre-forked warm spares for the inference process.
+
+    A cold inference process spends seconds in graph construction and
+    model deserialization before its first decision. The pool keeps
+    fully-initialized spares parked on an event after priming FaceMesh
+    with one blank frame; promoting one costs an Event.set(), so a
+    watchdog restart reaches first-decision in hundreds of milliseconds.
+    Each promotion forks a replacement spare in the background.
+    """
+
+    def __init__(self, ring_name, result_name, width, height, spares=1):
+        self._args = (ring_name, result_name, width, height)
+        self._spares = [self._fork() for _ in range(spares)]
+
+    def _fork(self):
+        start = Event()
+        proc = Process(target=inference_worker, args=self._args + (start,),
+                       daemon=True)
+        proc.start()
+        return proc, start
+
+    def promote(self):
+        """Unpark the oldest live spare and return it. A spare that died
+        alongside the active process is skipped; its replacement (forked
+        here) becomes the cold-start fallback."""
+        while self._spares:
+            proc, start = self._spares.pop(0)
+            self._spares.append(self._fork())
+            if proc.is_alive():
+                start.set()
+                return proc
+        proc, start = self._fork()
+        start.set()
+        return proc
+
+    def close(self):
+        for proc, _ in self._spares:
+            if proc.is_alive():
+                proc.terminate()
+                proc.join(timeout=2)
+
+
+class IsolatedTracker:
+    """Capture + decision process; inference runs out-of-process."""
+
+    def __init__(self, arduino_port=None, width=640, height=480,
+                 warm_spares=1):
+        import multi_stream
+        import serial_link
+
+        self.width = width
+        self.height = height
+        self.ring = FrameRing(create=True, width=width, height=height)
+        self.results = ResultBlock(create=True)
+        self.seat = multi_stream.SeatState(0, channel=0)
+        self.arduino = None
+        if arduino_port:
+            try:
+                self.arduino = serial_link.ArduinoLink(arduino_port)
+            except Exception as e:
+                print(f"Warning: Could not connect to Arduino: {e}")
+        self._proc = None
+        # Spares start forking (and priming their graphs) now, in
+        # parallel with the camera open below
+        self._pool = WarmPool(self.ring.name, self.results.name,
+                              width, height, spares=warm_spares)
+
+    def _spawn(self):
+        self._proc = self._pool.promote()
+
+    def _supervise(self):
+        """Respawn the inference side if it crashed. Decision state on
+        this side is untouched, so no episode is lost."""
+        if self._proc is None or not self._proc.is_alive():
+            if self._proc is not None:
+                print(f"Inference process died (exit {self._proc.exitcode}), "
+                      "restarting...")
+            self._spawn()
+
+    def run(self, camera_index=0):
+        import cv2
+
+        cap = cv2.VideoCapture(camera_index)
+        if not cap.isOpened():
+            print(f"Could not open camera {camera_index}")
+            return
+        cap.set(cv2.CAP_PROP_FRAME_WIDTH, self.width)
+        cap.set(cv2.CAP_PROP_FRAME_HEIGHT, self.height)
+        self._spawn()
+        last_result = 0
+        try:
+            while True:
+                self._supervise()
+                ret, frame = cap.read()
+                capture_ts = time.monotonic()
+                if not ret:
+                    print("Error: Could not read frame")
+                    break
+                self.ring.publish(cv2.flip(frame, 1), capture_ts)
+
+                item = self.results.latest(last_result)
+                if item is not None:
+                    last_result, ts, offsets = item[0], item[1], item[2]
+                    if self.seat.update(offsets, ts) and self.arduino:
+                        self.arduino.send_fire()
+        except KeyboardInterrupt:
+            pass
+        finally:
+            cap.release()
+            if self._proc and self._proc.is_alive():
+                self._proc.terminate()
+                self._proc.join(timeout=2)
+            self._pool.close()
+            if self.arduino:
+                self.arduino.close()
+            for block in (self.ring, self.results):
+                block.close()
+                block.unlink()
+
+
+if __name__ == '__main__':
+    IsolatedTracker(arduino_port='COM3').run(camera_index=0)
@@ -0,0 +1,37 @@
+"""Lightweight UDP telemetry for headless deployments.
+
+Kiosks without a display still need the status line that used to be
+drawn on the frame. Status is published as fire-and-forget UDP
+datagrams, deduplicated so an unchanged status only goes out once per
+heartbeat interval - the steady-state per-frame cost is a string compare.
+
+Listen with e.g.:  nc -klu 9910
+"""
+
+import socket
+import time
+
+
+class TelemetryPublisher:
+    def __init__(self, host='127.0.0.1', port=9910, heartbeat=1.0):
+        self._sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self._sock.setblocking(False)
+        self._addr = (host, port)
+        self.heartbeat = heartbeat
+        self._last_status = None
+        self._last_send = 0.0
+
+    def publish(self, status):
+        """Send the status line if it changed or the heartbeat is due."""
+        now = time.monotonic()
+        if status == self._last_status and now - self._last_send < self.heartbeat:
+            return
+        try:
+            self._sock.sendto((status + '\n').encode('utf-8'), self._addr)
+        except OSError:
+            pass  # no listener / transient network error; never stall the loop
+        self._last_status = status
+        self._last_send = now
+
+    def close(self):
+        self._sock.close()
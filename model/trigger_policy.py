@@ -0,0 +1,63 @@
+"""Configurable trigger policy for look-away episodes.
+
+The old signal_sent boolean meant exactly one Arduino signal per
+episode. TriggerPolicy evaluates in O(1) per frame from the same timer
+state and supports:
+
+  repeat_interval    re-fire every N seconds while still looking away
+                     (None = single-shot, the old behavior)
+  escalate_after     after this many seconds of continuous look-away,
+                     switch to escalate_interval between shots
+  burst_count        shots queued per trigger; with the non-blocking
+                     firmware queue these fire back-to-back at the
+                     servo's mechanical rate
+
+update() returns how many shots to queue for this frame.
+"""
+
+
+class TriggerPolicy:
+    def __init__(self, look_away_threshold=0.5, repeat_interval=None,
+                 escalate_after=None, escalate_interval=None, burst_count=1):
+        self.look_away_threshold = look_away_threshold
+        self.repeat_interval = repeat_interval
+        self.escalate_after = escalate_after
+        self.escalate_interval = escalate_interval
+        self.burst_count = burst_count
+        self._last_fire = None
+
+    @property
+    def fired(self):
+        """True once this episode has triggered at least once."""
+        return self._last_fire is not None
+
+    def reset(self):
+        """Call when the user looks back at the screen."""
+        self._last_fire = None
+
+    def restore(self, last_fire):
+        """Adopt fired state from a crash-recovery snapshot: the next
+        repeat interval counts from `last_fire` instead of re-firing."""
+        self._last_fire = last_fire
+
+    def update(self, elapsed, now):
+        """Evaluate one frame: elapsed seconds of continuous look-away,
+        now in the same (monotonic) clock. Returns shots to queue."""
+        if elapsed < self.look_away_threshold:
+            return 0
+
+        if self._last_fire is None:
+            self._last_fire = now
+            return self.burst_count
+
+        interval = self.repeat_interval
+        if (self.escalate_after is not None
+                and self.escalate_interval is not None
+                and elapsed >= self.escalate_after):
+            interval = self.escalate_interval
+        if interval is None:
+            return 0  # single-shot
+        if now - self._last_fire >= interval:
+            self._last_fire = now
+            return self.burst_count
+        return 0
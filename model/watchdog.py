@@ -0,0 +1,168 @@
+"""Watchdog-supervised running with crash-recovery state snapshots.
+
+When cap.read() fails, run() just breaks and the process dies; an
+operator finds a dead kiosk hours later and a manual restart pays the
+full cold start plus loses any in-flight look-away episode. Supervisor
+wraps the frame loop with automatic camera reopen (exponential backoff)
+and keeps a snapshot of the decision state in a small mmap'd file, so a
+restarted process - whether respawned by systemd or by hand - resumes
+the episode timer and calibration thresholds in under a second instead
+of starting an episode from zero.
+
+Snapshot file layout (little-endian, one fixed record):
+    magic 'GZS1' | wall ts f64 | episode elapsed f64 |
+    has_episode u8 | signal_sent u8 | h_threshold f32 | v_threshold f32
+
+Monotonic timestamps don't survive a restart, so the episode is stored
+as elapsed seconds plus the wall-clock save time; restore rebuilds the
+monotonic start from those and the snapshot's age. A snapshot older
+than MAX_AGE is stale - the user state is unknowable - and is ignored.
+
+Run a supervised tracker:
+    python watchdog.py
+"""
+
+import mmap
+import os
+import struct
+import time
+
+import cv2
+
+import profiling
+
+MAGIC = b'GZS1'
+_RECORD = struct.Struct('<4sddBBff')
+
+DEFAULT_PATH = os.path.join(os.path.expanduser('~'), '.eyetracker_state')
+
+
+class StateSnapshot:
+    # A snapshot older than this predates the fault by too much to say
+    # anything about the user now
+    MAX_AGE = 5.0  # seconds
+
+    def __init__(self, path=DEFAULT_PATH):
+        size = _RECORD.size
+        new = not os.path.exists(path) or os.path.getsize(path) != size
+        self._f = open(path, 'w+b' if new else 'r+b')
+        if new:
+            self._f.truncate(size)
+        self._mm = mmap.mmap(self._f.fileno(), size)
+        if new:
+            self._mm[:4] = b'\x00' * 4  # no magic: nothing to restore
+
+    def save(self, tracker):
+        """Write the tracker's decision state. A memcpy; no syscall."""
+        start = tracker.look_away_start_time
+        has_episode = start is not None
+        elapsed = time.monotonic() - start if has_episode else 0.0
+        _RECORD.pack_into(self._mm, 0, MAGIC, time.time(), elapsed,
+                          int(has_episode), int(tracker.signal_sent),
+                          tracker.horizontal_threshold,
+                          tracker.vertical_threshold)
+
+    def restore(self, tracker):
+        """Apply a fresh snapshot to the tracker. Returns True if one
+        was applied, False when there is none or it has gone stale."""
+        magic, ts, elapsed, has_episode, sent, h, v = _RECORD.unpack_from(
+            self._mm, 0)
+        if magic != MAGIC:
+            return False
+        age = time.time() - ts
+        if age < 0 or age > self.MAX_AGE:
+            return False
+
+        tracker.horizontal_threshold = h
+        tracker.vertical_threshold = v
+        if tracker.engine:
+            tracker.engine.set_thresholds(h, v)
+        if has_episode:
+            # The episode kept running while we were down
+            tracker.look_away_start_time = time.monotonic() - (elapsed + age)
+            tracker.signal_sent = bool(sent)
+            if sent:
+                # Already fired; rebase the policy so repeat intervals
+                # count from now rather than re-firing immediately
+                tracker.policy.restore(time.monotonic())
+        return True
+
+    def close(self):
+        self._mm.flush()
+        self._mm.close()
+        self._f.close()
+
+
+class Supervisor:
+    """Owns the frame loop for a tracker, surviving camera faults."""
+
+    def __init__(self, tracker, snapshot_path=DEFAULT_PATH,
+                 snapshot_interval=1.0):
+        self.tracker = tracker
+        self.snapshot = StateSnapshot(snapshot_path)
+        self.snapshot_interval = snapshot_interval
+
+    def run(self, camera_index=0):
+        """Run until the user quits; camera faults reopen with backoff."""
+        if self.snapshot.restore(self.tracker):
+            print("Resumed decision state from snapshot")
+
+        tracker = self.tracker
+        backoff = 0.5
+        last_snap = 0.0
+        cap = None
+        try:
+            while True:
+                cap = tracker._open_camera(camera_index)
+                if cap is None:
+                    print(f"Camera open failed, retrying in {backoff:.1f}s")
+                    time.sleep(backoff)
+                    backoff = min(backoff * 2, 10.0)
+                    continue
+                backoff = 0.5
+                print("Eye Tracker started (supervised). Press 'q' to quit.")
+
+                while True:
+                    with profiling.stage('capture'):
+                        ret, frame = cap.read()
+                    capture_ts = time.monotonic()
+                    if not ret:
+                        print("Camera read failed, reopening...")
+                        cap.release()
+                        cap = None
+                        break
+                    frame = cv2.flip(frame, 1)
+                    processed_frame, _ = tracker.process_frame(frame,
+                                                               capture_ts)
+                    if tracker.governor:
+                        tracker.governor.throttle(capture_ts)
+
+                    now = time.monotonic()
+                    if now - last_snap >= self.snapshot_interval:
+                        self.snapshot.save(tracker)
+                        last_snap = now
+
+                    if not tracker.headless:
+                        cv2.imshow('Eye Tracker', processed_frame)
+                        if cv2.waitKey(1) & 0xFF == ord('q'):
+                            return
+        finally:
+            # Every exit path - quit key, exception, read failure mid-
+            # reopen - releases the camera; we're a library class, not
+            # necessarily the whole process
+            if cap is not None:
+                cap.release()
+            if not tracker.headless:
+                cv2.destroyAllWindows()
+            self.snapshot.save(tracker)
+            self.snapshot.close()
+            if tracker.arduino:
+                tracker.arduino.close()
+                print("Arduino connection closed")
+
+
+if __name__ == '__main__':
+    from eye_tracking_model import EyeTracker
+
+    tracker = EyeTracker(arduino_port='COM3', use_arduino=True)
+    Supervisor(tracker).run(camera_index=0)